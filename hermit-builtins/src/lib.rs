@@ -1,6 +1,7 @@
 #![no_std]
 
 pub mod math;
+pub mod mem;
 
 #[panic_handler]
 fn panic(_info: &core::panic::PanicInfo) -> ! {
@@ -0,0 +1,242 @@
+//! Memory intrinsics for the final image.
+//!
+//! These override the portable byte-wise implementations of
+//! `compiler_builtins` (which are only linked weakly) with wider variants:
+//! small operations are handled with a pair of overlapping register-sized
+//! accesses, everything else is done in 16-byte blocks, which compile to
+//! vector loads and stores on all supported targets. On x86_64, large
+//! copies and fills additionally use `rep movsb`/`rep stosb` when the CPU
+//! advertises fast string operations (ERMS).
+
+use core::ffi::c_int;
+
+/// Size in bytes from which `rep movsb`/`rep stosb` beats a block copy loop
+/// on CPUs with ERMS.
+#[cfg(target_arch = "x86_64")]
+const REP_THRESHOLD: usize = 256;
+
+/// Returns whether the CPU supports Enhanced REP MOVSB/STOSB. The CPUID
+/// leaf is only queried once.
+#[cfg(target_arch = "x86_64")]
+fn has_erms() -> bool {
+	use core::sync::atomic::{AtomicU8, Ordering};
+
+	static ERMS: AtomicU8 = AtomicU8::new(0);
+
+	match ERMS.load(Ordering::Relaxed) {
+		0 => {
+			let detected = unsafe { core::arch::x86_64::__cpuid_count(7, 0) }.ebx & (1 << 9) != 0;
+			ERMS.store(if detected { 2 } else { 1 }, Ordering::Relaxed);
+			detected
+		}
+		state => state == 2,
+	}
+}
+
+/// Copies `n < 16` bytes with at most two overlapping accesses.
+unsafe fn copy_small(dest: *mut u8, src: *const u8, n: usize) {
+	unsafe {
+		if n >= 8 {
+			let head = (src as *const u64).read_unaligned();
+			let tail = (src.add(n - 8) as *const u64).read_unaligned();
+			(dest as *mut u64).write_unaligned(head);
+			(dest.add(n - 8) as *mut u64).write_unaligned(tail);
+		} else if n >= 4 {
+			let head = (src as *const u32).read_unaligned();
+			let tail = (src.add(n - 4) as *const u32).read_unaligned();
+			(dest as *mut u32).write_unaligned(head);
+			(dest.add(n - 4) as *mut u32).write_unaligned(tail);
+		} else if n >= 2 {
+			let head = (src as *const u16).read_unaligned();
+			let tail = (src.add(n - 2) as *const u16).read_unaligned();
+			(dest as *mut u16).write_unaligned(head);
+			(dest.add(n - 2) as *mut u16).write_unaligned(tail);
+		} else if n == 1 {
+			*dest = *src;
+		}
+	}
+}
+
+/// Copies `n` bytes from front to back. The ragged tail re-reads the last
+/// block of the source, so with overlapping regions, `dest` must be at
+/// least one block below `src`.
+unsafe fn copy_forward(dest: *mut u8, src: *const u8, n: usize) {
+	if n < 16 {
+		unsafe { copy_small(dest, src, n) };
+		return;
+	}
+
+	#[cfg(target_arch = "x86_64")]
+	if n >= REP_THRESHOLD && has_erms() {
+		unsafe {
+			core::arch::asm!(
+				"rep movsb",
+				inout("rdi") dest => _,
+				inout("rsi") src => _,
+				inout("rcx") n => _,
+				options(nostack),
+			);
+		}
+		return;
+	}
+
+	unsafe {
+		let mut i = 0;
+		while i + 16 <= n {
+			(dest.add(i) as *mut u128)
+				.write_unaligned((src.add(i) as *const u128).read_unaligned());
+			i += 16;
+		}
+		if i < n {
+			// The tail overlaps the last full block.
+			let off = n - 16;
+			(dest.add(off) as *mut u128)
+				.write_unaligned((src.add(off) as *const u128).read_unaligned());
+		}
+	}
+}
+
+/// Copies `n` bytes from back to front. The ragged head re-reads the
+/// first block of the source, so with overlapping regions, `dest` must be
+/// at least one block above `src`.
+unsafe fn copy_backward(dest: *mut u8, src: *const u8, n: usize) {
+	if n < 16 {
+		// The overlapping accesses read `src` completely before the first
+		// write to `dest`, so ordering does not matter here.
+		unsafe { copy_small(dest, src, n) };
+		return;
+	}
+
+	unsafe {
+		let mut i = n;
+		while i >= 16 {
+			i -= 16;
+			(dest.add(i) as *mut u128)
+				.write_unaligned((src.add(i) as *const u128).read_unaligned());
+		}
+		if i > 0 {
+			// The head overlaps the first full block.
+			(dest as *mut u128).write_unaligned((src as *const u128).read_unaligned());
+		}
+	}
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn memcpy(dest: *mut u8, src: *const u8, n: usize) -> *mut u8 {
+	unsafe { copy_forward(dest, src, n) };
+	dest
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn memmove(dest: *mut u8, src: *const u8, n: usize) -> *mut u8 {
+	// The block copies re-read up to 15 source bytes for the ragged tail
+	// (respectively head). If the regions overlap by less than a block,
+	// earlier block writes may already have covered those bytes, so copy
+	// byte-wise in that case. `copy_small` is safe for any overlap, since
+	// it reads the source completely before the first write.
+	if (dest as usize) < (src as usize) {
+		if n >= 16 && (src as usize) - (dest as usize) < 16 {
+			unsafe {
+				for i in 0..n {
+					*dest.add(i) = *src.add(i);
+				}
+			}
+		} else {
+			unsafe { copy_forward(dest, src, n) };
+		}
+	} else if (src as usize) + n <= (dest as usize) {
+		unsafe { copy_forward(dest, src, n) };
+	} else if n >= 16 && (dest as usize) - (src as usize) < 16 {
+		unsafe {
+			for i in (0..n).rev() {
+				*dest.add(i) = *src.add(i);
+			}
+		}
+	} else {
+		unsafe { copy_backward(dest, src, n) };
+	}
+	dest
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn memset(dest: *mut u8, c: c_int, n: usize) -> *mut u8 {
+	let byte = c as u8;
+
+	if n < 16 {
+		let splat = u64::from(byte) * 0x0101_0101_0101_0101;
+		unsafe {
+			if n >= 8 {
+				(dest as *mut u64).write_unaligned(splat);
+				(dest.add(n - 8) as *mut u64).write_unaligned(splat);
+			} else if n >= 4 {
+				(dest as *mut u32).write_unaligned(splat as u32);
+				(dest.add(n - 4) as *mut u32).write_unaligned(splat as u32);
+			} else if n >= 2 {
+				(dest as *mut u16).write_unaligned(splat as u16);
+				(dest.add(n - 2) as *mut u16).write_unaligned(splat as u16);
+			} else if n == 1 {
+				*dest = byte;
+			}
+		}
+		return dest;
+	}
+
+	#[cfg(target_arch = "x86_64")]
+	if n >= REP_THRESHOLD && has_erms() {
+		unsafe {
+			core::arch::asm!(
+				"rep stosb",
+				inout("rdi") dest => _,
+				inout("rcx") n => _,
+				in("al") byte,
+				options(nostack),
+			);
+		}
+		return dest;
+	}
+
+	let splat = u128::from(byte) * 0x0101_0101_0101_0101_0101_0101_0101_0101;
+	unsafe {
+		let mut i = 0;
+		while i + 16 <= n {
+			(dest.add(i) as *mut u128).write_unaligned(splat);
+			i += 16;
+		}
+		if i < n {
+			(dest.add(n - 16) as *mut u128).write_unaligned(splat);
+		}
+	}
+
+	dest
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn memcmp(s1: *const u8, s2: *const u8, n: usize) -> c_int {
+	unsafe {
+		let mut i = 0;
+		while i + 8 <= n {
+			let a = (s1.add(i) as *const u64).read_unaligned();
+			let b = (s2.add(i) as *const u64).read_unaligned();
+			if a != b {
+				// All supported targets are little-endian, so the lowest
+				// differing byte is the first differing byte.
+				let byte = (a ^ b).trailing_zeros() as usize / 8;
+				return c_int::from(*s1.add(i + byte)) - c_int::from(*s2.add(i + byte));
+			}
+			i += 8;
+		}
+		while i < n {
+			if *s1.add(i) != *s2.add(i) {
+				return c_int::from(*s1.add(i)) - c_int::from(*s2.add(i));
+			}
+			i += 1;
+		}
+	}
+
+	0
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn bcmp(s1: *const u8, s2: *const u8, n: usize) -> c_int {
+	unsafe { memcmp(s1, s2, n) }
+}
@@ -6,7 +6,7 @@ use core::ptr;
 use core::sync::atomic::Ordering;
 
 #[cfg(feature = "smp")]
-use hermit_sync::InterruptTicketMutex;
+use hermit_sync::OnceCell;
 
 use super::interrupts::{IrqStatistics, IRQ_COUNTERS};
 use super::CPU_ONLINE;
@@ -25,9 +25,13 @@ pub(crate) struct CoreLocal {
 	irq_statistics: &'static IrqStatistics,
 	/// Queue of async tasks
 	async_tasks: RefCell<Vec<AsyncTask>>,
-	/// Queues to handle incoming requests from the other cores
+	/// Queues to handle incoming requests from the other cores.
+	///
+	/// Initialized when the core's scheduler is registered, since creating
+	/// the queues allocates and `install` runs before the heap is
+	/// available.
 	#[cfg(feature = "smp")]
-	pub scheduler_input: InterruptTicketMutex<SchedulerInput>,
+	pub scheduler_input: OnceCell<SchedulerInput>,
 }
 
 impl CoreLocal {
@@ -48,7 +52,7 @@ impl CoreLocal {
 			irq_statistics,
 			async_tasks: RefCell::new(Vec::new()),
 			#[cfg(feature = "smp")]
-			scheduler_input: InterruptTicketMutex::new(SchedulerInput::new()),
+			scheduler_input: OnceCell::new(),
 		};
 		let this = if core_id == 0 {
 			take_static::take_static! {
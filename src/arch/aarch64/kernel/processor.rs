@@ -142,6 +142,11 @@ pub fn get_frequency() -> u16 {
 	(CPU_FREQUENCY.get() / 1000000).try_into().unwrap()
 }
 
+/// Returns the frequency of the timestamp counter in Hz.
+pub fn get_timestamp_frequency() -> u64 {
+	u64::from(CPU_FREQUENCY.get())
+}
+
 #[inline]
 pub fn get_timestamp() -> u64 {
 	let value: u64;
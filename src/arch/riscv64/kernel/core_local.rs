@@ -6,7 +6,7 @@ use core::ptr;
 use core::sync::atomic::Ordering;
 
 #[cfg(feature = "smp")]
-use hermit_sync::InterruptTicketMutex;
+use hermit_sync::OnceCell;
 
 use crate::arch::riscv64::kernel::CPU_ONLINE;
 use crate::executor::task::AsyncTask;
@@ -23,9 +23,13 @@ pub struct CoreLocal {
 	pub kernel_stack: Cell<u64>,
 	/// Queue of async tasks
 	async_tasks: RefCell<Vec<AsyncTask>>,
-	/// Queues to handle incoming requests from the other cores
+	/// Queues to handle incoming requests from the other cores.
+	///
+	/// Initialized when the core's scheduler is registered, since creating
+	/// the queues allocates and `install` runs before the heap is
+	/// available.
 	#[cfg(feature = "smp")]
-	pub scheduler_input: InterruptTicketMutex<SchedulerInput>,
+	pub scheduler_input: OnceCell<SchedulerInput>,
 }
 
 impl CoreLocal {
@@ -43,7 +47,7 @@ impl CoreLocal {
 				kernel_stack: Cell::new(0),
 				async_tasks: RefCell::new(Vec::new()),
 				#[cfg(feature = "smp")]
-				scheduler_input: InterruptTicketMutex::new(SchedulerInput::new()),
+				scheduler_input: OnceCell::new(),
 			};
 			let this = if core_id == 0 {
 				take_static::take_static! {
@@ -252,6 +252,11 @@ pub fn get_frequency() -> u16 {
 	(get_timebase_freq() / 1000000).try_into().unwrap()
 }
 
+/// Returns the frequency of the timestamp counter in Hz.
+pub fn get_timestamp_frequency() -> u64 {
+	get_timebase_freq()
+}
+
 #[inline]
 pub fn get_timestamp() -> u64 {
 	time::read64()
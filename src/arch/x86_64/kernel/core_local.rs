@@ -7,14 +7,17 @@ use core::sync::atomic::AtomicBool;
 use core::sync::atomic::Ordering;
 use core::{mem, ptr};
 
+use hermit_sync::InterruptSpinMutex;
+#[cfg(feature = "smp")]
+use hermit_sync::OnceCell;
 #[cfg(feature = "smp")]
-use hermit_sync::InterruptTicketMutex;
 use x86_64::registers::model_specific::GsBase;
 use x86_64::structures::tss::TaskStateSegment;
 use x86_64::VirtAddr;
 
 use super::interrupts::{IrqStatistics, IRQ_COUNTERS};
 use super::CPU_ONLINE;
+use crate::arch::x86_64::mm::physicalmem::FrameCache;
 use crate::executor::task::AsyncTask;
 #[cfg(feature = "smp")]
 use crate::scheduler::SchedulerInput;
@@ -34,11 +37,17 @@ pub(crate) struct CoreLocal {
 	irq_statistics: &'static IrqStatistics,
 	/// Queue of async tasks
 	async_tasks: RefCell<Vec<AsyncTask>>,
+	/// Cache of physical page frames for this CPU Core.
+	pub frame_cache: InterruptSpinMutex<FrameCache>,
 	#[cfg(feature = "smp")]
 	pub hlt: AtomicBool,
-	/// Queues to handle incoming requests from the other cores
+	/// Queues to handle incoming requests from the other cores.
+	///
+	/// Initialized when the core's scheduler is registered, since creating
+	/// the queues allocates and `install` runs before the heap is
+	/// available.
 	#[cfg(feature = "smp")]
-	pub scheduler_input: InterruptTicketMutex<SchedulerInput>,
+	pub scheduler_input: OnceCell<SchedulerInput>,
 }
 
 impl CoreLocal {
@@ -62,10 +71,11 @@ impl CoreLocal {
 			kernel_stack: Cell::new(ptr::null_mut()),
 			irq_statistics,
 			async_tasks: RefCell::new(Vec::new()),
+			frame_cache: InterruptSpinMutex::new(FrameCache::new()),
 			#[cfg(feature = "smp")]
 			hlt: AtomicBool::new(false),
 			#[cfg(feature = "smp")]
-			scheduler_input: InterruptTicketMutex::new(SchedulerInput::new()),
+			scheduler_input: OnceCell::new(),
 		};
 		let this = if core_id == 0 {
 			take_static::take_static! {
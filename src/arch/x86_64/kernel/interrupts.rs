@@ -76,6 +76,10 @@ pub(crate) fn enable_and_wait() {
 		#[cfg(feature = "smp")]
 		crate::CoreLocal::get().hlt.store(true, Ordering::Relaxed);
 		enable_and_hlt();
+		// The core may have been woken up without a wakeup IPI (e.g. by
+		// a timer interrupt), which leaves the flag set.
+		#[cfg(feature = "smp")]
+		crate::CoreLocal::get().hlt.store(false, Ordering::Relaxed);
 	}
 }
 
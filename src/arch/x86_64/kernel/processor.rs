@@ -1070,6 +1070,11 @@ pub fn get_frequency() -> u16 {
 	CPU_FREQUENCY.get()
 }
 
+/// Returns the frequency of the timestamp counter in Hz.
+pub fn get_timestamp_frequency() -> u64 {
+	u64::from(get_frequency()) * 1_000_000
+}
+
 #[inline]
 pub fn readfs() -> usize {
 	if cfg!(feature = "fsgsbase") {
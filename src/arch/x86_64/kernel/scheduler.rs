@@ -225,10 +225,15 @@ impl Drop for TaskStacks {
 					stacks.total_size >> 10,
 				);
 
-				crate::arch::mm::paging::unmap::<BasePageSize>(
+				// Flush the whole range in one batch, shooting down the other
+				// cores' TLBs once instead of invalidating page by page.
+				let mut batch = crate::arch::mm::paging::TlbFlushBatch::new();
+				crate::arch::mm::paging::unmap_batched::<BasePageSize>(
 					stacks.virt_addr,
 					stacks.total_size / BasePageSize::SIZE as usize + 4,
+					&mut batch,
 				);
+				batch.flush();
 				crate::arch::mm::virtualmem::deallocate(
 					stacks.virt_addr,
 					stacks.total_size + 4 * BasePageSize::SIZE as usize,
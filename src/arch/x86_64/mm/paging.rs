@@ -1,3 +1,4 @@
+use alloc::vec::Vec;
 use core::fmt::Debug;
 use core::ptr;
 
@@ -7,7 +8,11 @@ use x86_64::registers::control::Cr2;
 use x86_64::registers::segmentation::SegmentSelector;
 pub use x86_64::structures::idt::InterruptStackFrame as ExceptionStackFrame;
 use x86_64::structures::idt::PageFaultErrorCode;
+#[cfg(not(feature = "common-os"))]
+use x86_64::structures::paging::mapper::CleanUp;
 use x86_64::structures::paging::mapper::{TranslateResult, UnmapError};
+#[cfg(not(feature = "common-os"))]
+use x86_64::structures::paging::FrameDeallocator;
 pub use x86_64::structures::paging::PageTableFlags as PageTableEntryFlags;
 use x86_64::structures::paging::{
 	Mapper, Page, PageTableIndex, PhysFrame, RecursivePageTable, Size2MiB, Translate,
@@ -123,6 +128,53 @@ pub fn virt_to_phys(virtual_address: VirtAddr) -> PhysAddr {
 	virtual_to_physical(virtual_address).unwrap()
 }
 
+/// Translate a virtual memory address to the frame that backs it and the size
+/// of the page it is mapped with.
+#[cfg(not(feature = "common-os"))]
+pub fn translate_mapping(virtual_address: VirtAddr) -> Option<(PhysAddr, u64)> {
+	let virtual_address = x86_64::VirtAddr::new(virtual_address.0);
+	let page_table = unsafe { recursive_page_table() };
+
+	match page_table.translate(virtual_address) {
+		TranslateResult::NotMapped | TranslateResult::InvalidFrameAddress(_) => None,
+		TranslateResult::Mapped { frame, .. } => {
+			Some((PhysAddr(frame.start_address().as_u64()), frame.size()))
+		}
+	}
+}
+
+/// Returns page table frames to the physical memory manager.
+#[cfg(not(feature = "common-os"))]
+struct PageTableFrameDeallocator;
+
+#[cfg(not(feature = "common-os"))]
+unsafe impl FrameDeallocator<BasePageSize> for PageTableFrameDeallocator {
+	unsafe fn deallocate_frame(&mut self, frame: PhysFrame<BasePageSize>) {
+		physicalmem::deallocate(
+			PhysAddr(frame.start_address().as_u64()),
+			BasePageSize::SIZE as usize,
+		);
+	}
+}
+
+/// Frees empty page tables within the given range and clears the entries
+/// pointing to them, so that a larger page can be mapped there afterwards.
+#[cfg(not(feature = "common-os"))]
+pub fn clean_up_range(virtual_address: VirtAddr, size: usize) {
+	let range = {
+		let start =
+			Page::<BasePageSize>::containing_address(x86_64::VirtAddr::new(virtual_address.0));
+		let end = Page::<BasePageSize>::containing_address(x86_64::VirtAddr::new(
+			virtual_address.0 + size as u64 - 1,
+		));
+		Page::range_inclusive(start, end)
+	};
+
+	unsafe {
+		recursive_page_table().clean_up_addr_range(range, &mut PageTableFrameDeallocator);
+	}
+}
+
 /// Maps a continuous range of pages.
 ///
 /// # Arguments
@@ -233,7 +285,98 @@ where
 	}
 }
 
-pub fn unmap<S>(virtual_address: VirtAddr, count: usize)
+/// Gathered TLB invalidations that are flushed in one batch.
+///
+/// Unmap-heavy paths like `sys_munmap` or the scheduler's stack teardown
+/// would otherwise invalidate their pages one at a time and shoot down the
+/// other cores' TLBs once per operation. Queued ranges are coalesced and
+/// flushed with a single shootdown; above [`Self::FULL_FLUSH_THRESHOLD`]
+/// entries, the whole TLB is flushed instead.
+#[must_use = "the gathered TLB invalidations have to be flushed"]
+pub struct TlbFlushBatch {
+	/// Coalesced address ranges whose pages have to be invalidated.
+	ranges: Vec<FlushRange>,
+	/// Total number of queued page table entries.
+	entries: usize,
+}
+
+/// A continuous range of pages of the same size to invalidate.
+struct FlushRange {
+	start: u64,
+	end: u64,
+	page_size: u64,
+}
+
+impl TlbFlushBatch {
+	/// Number of page table entries above which the whole TLB is flushed
+	/// instead of invalidating one page at a time.
+	const FULL_FLUSH_THRESHOLD: usize = 64;
+
+	pub const fn new() -> Self {
+		Self {
+			ranges: Vec::new(),
+			entries: 0,
+		}
+	}
+
+	/// Queues `count` pages at `virtual_address` for invalidation.
+	fn add<S: PageSize>(&mut self, virtual_address: VirtAddr, count: usize) {
+		let start = virtual_address.align_down(S::SIZE).0;
+		let end = start + count as u64 * S::SIZE;
+		self.entries += count;
+
+		// Unmaps walk their addresses in ascending order, so coalescing with
+		// the most recently queued range is all that is needed in practice.
+		if let Some(range) = self.ranges.last_mut() {
+			if range.page_size == S::SIZE && range.end == start {
+				range.end = end;
+				return;
+			}
+		}
+
+		self.ranges.push(FlushRange {
+			start,
+			end,
+			page_size: S::SIZE,
+		});
+	}
+
+	/// Flushes all queued invalidations on this core.
+	///
+	/// Returns `true` if anything was flushed.
+	fn flush_local(self) -> bool {
+		if self.entries == 0 {
+			return false;
+		}
+
+		if self.entries >= Self::FULL_FLUSH_THRESHOLD {
+			tlb::flush_all();
+		} else {
+			for range in &self.ranges {
+				for addr in (range.start..range.end).step_by(range.page_size as usize) {
+					tlb::flush(x86_64::VirtAddr::new(addr));
+				}
+			}
+		}
+
+		true
+	}
+
+	/// Flushes all queued invalidations and shoots down the TLBs of the
+	/// other cores.
+	pub fn flush(self) {
+		#[cfg(feature = "smp")]
+		if self.flush_local() {
+			crate::arch::x86_64::kernel::apic::ipi_tlb_flush();
+		}
+		#[cfg(not(feature = "smp"))]
+		self.flush_local();
+	}
+}
+
+/// Unmaps a continuous range of pages, queueing the TLB invalidations in
+/// `batch` instead of flushing them immediately.
+pub fn unmap_batched<S>(virtual_address: VirtAddr, count: usize, batch: &mut TlbFlushBatch)
 where
 	S: PageSize + Debug,
 	RecursivePageTable<'static>: Mapper<S>,
@@ -251,7 +394,7 @@ where
 	for page in range {
 		let mut page_table = unsafe { recursive_page_table() };
 		match page_table.unmap(page) {
-			Ok((_frame, flush)) => flush.flush(),
+			Ok((_frame, flush)) => flush.ignore(),
 			// FIXME: Some sentinel pages around stacks are supposed to be unmapped.
 			// We should handle this case there instead of here.
 			Err(UnmapError::PageNotMapped) => {
@@ -260,6 +403,18 @@ where
 			Err(err) => panic!("{err:?}"),
 		}
 	}
+
+	batch.add::<S>(virtual_address, count);
+}
+
+pub fn unmap<S>(virtual_address: VirtAddr, count: usize)
+where
+	S: PageSize + Debug,
+	RecursivePageTable<'static>: Mapper<S>,
+{
+	let mut batch = TlbFlushBatch::new();
+	unmap_batched::<S>(virtual_address, count, &mut batch);
+	batch.flush_local();
 }
 
 #[cfg(not(feature = "common-os"))]
@@ -267,6 +422,23 @@ pub(crate) extern "x86-interrupt" fn page_fault_handler(
 	stack_frame: ExceptionStackFrame,
 	error_code: PageFaultErrorCode,
 ) {
+	let address = VirtAddr(Cr2::read().unwrap().as_u64());
+
+	crate::instrumentation::tracepoint(
+		crate::instrumentation::TracepointKind::PageFault,
+		address.as_u64(),
+		error_code.bits(),
+	);
+
+	// Fault in pages of demand-paged memory mappings.
+	if mm::demand_paging::page_fault(
+		address,
+		error_code.contains(PageFaultErrorCode::CAUSED_BY_WRITE),
+		error_code.contains(PageFaultErrorCode::INSTRUCTION_FETCH),
+	) {
+		return;
+	}
+
 	error!("Page fault (#PF)!");
 	error!("page_fault_linear_address = {:p}", Cr2::read().unwrap());
 	error!("error_code = {error_code:?}");
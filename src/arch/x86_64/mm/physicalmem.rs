@@ -4,6 +4,7 @@ use free_list::{AllocError, FreeList, PageLayout, PageRange};
 use hermit_sync::InterruptTicketMutex;
 use multiboot::information::{MemoryType, Multiboot};
 
+use crate::arch::x86_64::kernel::core_local::CoreLocal;
 use crate::arch::x86_64::kernel::{get_fdt, get_limit, get_mbinfo};
 use crate::arch::x86_64::mm::paging::{BasePageSize, PageSize};
 use crate::arch::x86_64::mm::{MultibootMemory, PhysAddr, VirtAddr};
@@ -13,6 +14,43 @@ pub static PHYSICAL_FREE_LIST: InterruptTicketMutex<FreeList<16>> =
 	InterruptTicketMutex::new(FreeList::new());
 static TOTAL_MEMORY: AtomicUsize = AtomicUsize::new(0);
 
+/// Number of base-page frames cached per CPU core.
+const FRAME_CACHE_SIZE: usize = 64;
+
+/// A per-core cache of base-page frames in front of [`PHYSICAL_FREE_LIST`].
+///
+/// Base-page allocations are served from this cache and only refill from the
+/// global free list in batches, so cores allocating single frames (page
+/// faults, task stacks, virtqueue buffers) do not contend on the global lock.
+pub(crate) struct FrameCache {
+	frames: [usize; FRAME_CACHE_SIZE],
+	len: usize,
+}
+
+impl FrameCache {
+	pub const fn new() -> Self {
+		Self {
+			frames: [0; FRAME_CACHE_SIZE],
+			len: 0,
+		}
+	}
+
+	fn pop(&mut self) -> Option<PhysAddr> {
+		self.len = self.len.checked_sub(1)?;
+		Some(PhysAddr(self.frames[self.len] as u64))
+	}
+
+	fn push(&mut self, frame: PhysAddr) -> Result<(), ()> {
+		if self.len == FRAME_CACHE_SIZE {
+			return Err(());
+		}
+
+		self.frames[self.len] = frame.as_usize();
+		self.len += 1;
+		Ok(())
+	}
+}
+
 const KVM_32BIT_MAX_MEM_SIZE: usize = 1 << 32;
 const KVM_32BIT_GAP_SIZE: usize = 768 << 20;
 const KVM_32BIT_GAP_START: usize = KVM_32BIT_MAX_MEM_SIZE - KVM_32BIT_GAP_SIZE;
@@ -165,6 +203,10 @@ pub fn allocate(size: usize) -> Result<PhysAddr, AllocError> {
 		BasePageSize::SIZE
 	);
 
+	if size == BasePageSize::SIZE as usize {
+		return allocate_base_page();
+	}
+
 	let layout = PageLayout::from_size(size).unwrap();
 
 	Ok(PhysAddr(
@@ -177,6 +219,39 @@ pub fn allocate(size: usize) -> Result<PhysAddr, AllocError> {
 	))
 }
 
+/// Allocates a single base-page frame from the current core's frame cache.
+fn allocate_base_page() -> Result<PhysAddr, AllocError> {
+	let mut cache = CoreLocal::get().frame_cache.lock();
+
+	if let Some(frame) = cache.pop() {
+		return Ok(frame);
+	}
+
+	// Refill half of the cache with a single allocation from the global free
+	// list, so that the remaining slots can still take deallocated frames
+	// without draining the cache right away.
+	let layout = PageLayout::from_size(FRAME_CACHE_SIZE / 2 * BasePageSize::SIZE as usize).unwrap();
+	if let Ok(range) = PHYSICAL_FREE_LIST.lock().allocate(layout) {
+		let mut frames = (range.start()..range.end()).step_by(BasePageSize::SIZE as usize);
+		let first = frames.next().unwrap();
+		for frame in frames {
+			cache.push(PhysAddr(frame as u64)).unwrap();
+		}
+		return Ok(PhysAddr(first as u64));
+	}
+
+	// The global free list may be too fragmented for a contiguous batch.
+	let layout = PageLayout::from_size(BasePageSize::SIZE as usize).unwrap();
+	Ok(PhysAddr(
+		PHYSICAL_FREE_LIST
+			.lock()
+			.allocate(layout)?
+			.start()
+			.try_into()
+			.unwrap(),
+	))
+}
+
 pub fn allocate_aligned(size: usize, align: usize) -> Result<PhysAddr, AllocError> {
 	assert!(size > 0);
 	assert!(align > 0);
@@ -221,6 +296,10 @@ pub fn deallocate(physical_address: PhysAddr, size: usize) {
 		BasePageSize::SIZE
 	);
 
+	if size == BasePageSize::SIZE as usize {
+		return deallocate_base_page(physical_address);
+	}
+
 	let range = PageRange::from_start_len(physical_address.as_usize(), size).unwrap();
 
 	unsafe {
@@ -228,6 +307,26 @@ pub fn deallocate(physical_address: PhysAddr, size: usize) {
 	}
 }
 
+/// Returns a single base-page frame to the current core's frame cache.
+fn deallocate_base_page(frame: PhysAddr) {
+	let mut cache = CoreLocal::get().frame_cache.lock();
+
+	if cache.push(frame).is_err() {
+		// The cache is full, drain half of it to the global free list, where
+		// the frames can coalesce again.
+		let mut free_list = PHYSICAL_FREE_LIST.lock();
+		for _ in 0..FRAME_CACHE_SIZE / 2 {
+			let frame = cache.pop().unwrap();
+			let range =
+				PageRange::from_start_len(frame.as_usize(), BasePageSize::SIZE as usize).unwrap();
+			unsafe {
+				free_list.deallocate(range).unwrap();
+			}
+		}
+		cache.push(frame).unwrap();
+	}
+}
+
 #[allow(dead_code)]
 #[cfg(not(feature = "pci"))]
 pub fn reserve(physical_address: PhysAddr, size: usize) {
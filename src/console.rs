@@ -1,9 +1,23 @@
-use core::fmt;
+use alloc::vec::Vec;
+use core::sync::atomic::{AtomicBool, Ordering};
+use core::task::Poll;
+use core::{fmt, future};
 
 use hermit_sync::InterruptTicketMutex;
 
 use crate::arch;
 
+/// Maximum number of bytes buffered before writers drain the buffer
+/// themselves.
+const BUFFER_CAPACITY: usize = 8192;
+
+/// Whether console output is buffered or written to the hardware directly.
+static BUFFERED: AtomicBool = AtomicBool::new(false);
+
+/// Buffered console output, waiting to be written to the hardware by
+/// [`drain`].
+static BUFFER: InterruptTicketMutex<Vec<u8>> = InterruptTicketMutex::new(Vec::new());
+
 pub(crate) struct Console(());
 
 /// A collection of methods that are required to format
@@ -13,14 +27,71 @@ impl fmt::Write for Console {
 	#[inline]
 	fn write_str(&mut self, s: &str) -> fmt::Result {
 		if !s.is_empty() {
-			let buf = s.as_bytes();
-			arch::output_message_buf(buf);
+			write(s.as_bytes());
 		}
 
 		Ok(())
 	}
 }
 
+/// Writes `buf` to the console.
+///
+/// In buffered mode, the bytes are only appended to [`BUFFER`] and written
+/// to the hardware later by [`drain`], so writers do not stall on the
+/// UART. Output that does not fit into the buffer is written on the spot.
+pub(crate) fn write(buf: &[u8]) {
+	if !BUFFERED.load(Ordering::Relaxed) {
+		arch::output_message_buf(buf);
+		return;
+	}
+
+	let mut pending = BUFFER.lock();
+	if pending.len() + buf.len() > BUFFER_CAPACITY {
+		// The buffer runs full faster than the drain task empties it.
+		// Drain it synchronously instead of losing output.
+		arch::output_message_buf(&pending);
+		pending.clear();
+	}
+	if buf.len() > BUFFER_CAPACITY {
+		arch::output_message_buf(buf);
+	} else {
+		pending.extend_from_slice(buf);
+	}
+}
+
+/// Writes all buffered console output to the hardware.
+fn flush() {
+	let mut pending = BUFFER.lock();
+	if !pending.is_empty() {
+		arch::output_message_buf(&pending);
+		pending.clear();
+	}
+}
+
+/// Switches the console to buffered mode. Requires a running [`drain`]
+/// task to get the buffered output written to the hardware.
+pub(crate) fn enable_buffering() {
+	BUFFERED.store(true, Ordering::Relaxed);
+}
+
+/// Switches the console back to direct mode and writes all buffered
+/// output to the hardware. Used on shutdown and panic, where the drain
+/// task does not run anymore.
+pub(crate) fn disable_buffering() {
+	BUFFERED.store(false, Ordering::Relaxed);
+	flush();
+}
+
+/// Background task that writes buffered console output to the hardware in
+/// batches whenever the executor runs.
+pub(crate) async fn drain() {
+	future::poll_fn(|_cx| {
+		flush();
+		Poll::<()>::Pending
+	})
+	.await;
+}
+
 static CONSOLE: InterruptTicketMutex<Console> = InterruptTicketMutex::new(Console(()));
 
 #[doc(hidden)]
@@ -1,9 +1,10 @@
 use alloc::boxed::Box;
+use alloc::collections::BTreeMap;
 use alloc::rc::Rc;
 use alloc::string::{String, ToString};
 use alloc::vec::Vec;
 use core::mem::MaybeUninit;
-use core::str;
+use core::{mem, str};
 
 use pci_types::InterruptLine;
 use virtio::fs::ConfigVolatileFieldAccess;
@@ -16,11 +17,13 @@ use crate::drivers::virtio::error::VirtioFsError;
 #[cfg(not(feature = "pci"))]
 use crate::drivers::virtio::transport::mmio::{ComCfg, IsrStatus, NotifCfg};
 #[cfg(feature = "pci")]
-use crate::drivers::virtio::transport::pci::{ComCfg, IsrStatus, NotifCfg};
+use crate::drivers::virtio::transport::pci::{ComCfg, IsrStatus, NotifCfg, ShMemCfg};
 use crate::drivers::virtio::virtqueue::error::VirtqError;
 use crate::drivers::virtio::virtqueue::split::SplitVq;
-use crate::drivers::virtio::virtqueue::{AsSliceU8, BufferType, Virtq, VqIndex, VqSize};
-use crate::fs::fuse::{self, FuseInterface, Rsp, RspHeader};
+use crate::drivers::virtio::virtqueue::{
+	AsSliceU8, BufferToken, BufferType, TransferToken, Virtq, VqIndex, VqSize,
+};
+use crate::fs::fuse::{self, FuseInterface, RspHeader};
 
 /// A wrapper struct for the raw configuration structure.
 /// Handling the right access to fields, as some are read-only
@@ -31,6 +34,15 @@ pub(crate) struct FsDevCfg {
 	pub features: virtio::fs::F,
 }
 
+/// A command that has been dispatched to the device and whose transfers have
+/// not all completed yet.
+pub(super) struct InFlightCmd {
+	/// Receives the buffer tokens of completed transfers.
+	completed_queue: async_channel::Receiver<Box<BufferToken>>,
+	/// Number of transfers of the command that have not completed yet.
+	remaining: usize,
+}
+
 /// Virtio file system driver struct.
 ///
 /// Struct allows to control devices virtqueues as also
@@ -43,6 +55,14 @@ pub(crate) struct VirtioFsDriver {
 	pub(super) notif_cfg: NotifCfg,
 	pub(super) vqueues: Vec<Rc<dyn Virtq>>,
 	pub(super) irq: InterruptLine,
+	/// In-flight commands by their ID.
+	pub(super) in_flight: BTreeMap<u64, InFlightCmd>,
+	/// ID for the next dispatched command.
+	pub(super) next_id: u64,
+	/// The device's DAX window (shared memory region), if it offers one.
+	pub(super) dax_window: Option<ShMemCfg>,
+	/// Offsets of the free [`fuse::DAX_SLOT_SIZE`] slots of the DAX window.
+	pub(super) dax_free_slots: Vec<u64>,
 }
 
 // Backend-independent interface for Virtio network driver
@@ -143,24 +163,41 @@ impl VirtioFsDriver {
 		// At this point the device is "live"
 		self.com_cfg.drv_ok();
 
+		// Carve the DAX window into fixed-size slots, into which file
+		// handles can map file ranges for direct access.
+		if let Some(window) = &self.dax_window {
+			let slots = window.len() / fuse::DAX_SLOT_SIZE;
+			self.dax_free_slots = (0..slots as u64)
+				.map(|n| n * fuse::DAX_SLOT_SIZE as u64)
+				.collect();
+			info!(
+				"Virtio-fs device {:x} offers a DAX window with {} slots.",
+				self.dev_cfg.dev_id, slots
+			);
+		}
+
 		Ok(())
 	}
-}
 
-impl FuseInterface for VirtioFsDriver {
-	fn send_command<O: fuse::ops::Op>(
-		&mut self,
+	/// Allocates the ID for the next in-flight command.
+	fn allocate_id(&mut self) -> u64 {
+		let id = self.next_id;
+		self.next_id = self.next_id.wrapping_add(1);
+		id
+	}
+
+	/// Prepares the transfer of a command on the request queue along with the
+	/// uninitialized response buffers the device writes into.
+	fn prepare_transfer<O: fuse::ops::Op>(
+		&self,
 		cmd: fuse::Cmd<O>,
 		rsp_payload_len: u32,
-	) -> Result<fuse::Rsp<O>, VirtqError> {
-		let fuse::Cmd {
-			headers: cmd_headers,
-			payload: cmd_payload_opt,
-		} = cmd;
-		let send: &[&[u8]] = if let Some(cmd_payload) = cmd_payload_opt.as_deref() {
-			&[cmd_headers.as_slice_u8(), cmd_payload]
+		id: u64,
+	) -> Result<(TransferToken, fuse::PendingRsp<O>), VirtqError> {
+		let send: &[&[u8]] = if let Some(cmd_payload) = cmd.payload.as_deref() {
+			&[cmd.headers.as_slice_u8(), cmd_payload]
 		} else {
-			&[cmd_headers.as_slice_u8()]
+			&[cmd.headers.as_slice_u8()]
 		};
 
 		let mut rsp_headers = Box::<RspHeader<O>>::new_uninit();
@@ -176,17 +213,123 @@ impl FuseInterface for VirtioFsDriver {
 			]
 		};
 
-		let transfer_tkn = self.vqueues[1]
-			.clone()
-			.prep_transfer_from_raw(send, recv, BufferType::Direct)
-			.unwrap();
-		transfer_tkn.dispatch_blocking()?;
-		Ok(unsafe {
-			Rsp {
-				headers: rsp_headers.assume_init(),
-				payload: rsp_payload_opt.map(|slice| Box::<[MaybeUninit<_>]>::assume_init(slice)),
+		let transfer_tkn =
+			self.vqueues[1]
+				.clone()
+				.prep_transfer_from_raw(send, recv, BufferType::Direct)?;
+
+		// The transfer references the buffers of the command by raw pointer,
+		// so the pending response keeps the command alive until completion.
+		let pending = fuse::PendingRsp {
+			id,
+			cmd,
+			headers: rsp_headers,
+			payload: rsp_payload_opt,
+		};
+
+		Ok((transfer_tkn, pending))
+	}
+}
+
+impl FuseInterface for VirtioFsDriver {
+	fn dispatch_command<O: fuse::ops::Op>(
+		&mut self,
+		cmd: fuse::Cmd<O>,
+		rsp_payload_len: u32,
+	) -> Result<fuse::PendingRsp<O>, VirtqError> {
+		let id = self.allocate_id();
+		let (transfer_tkn, pending) = self.prepare_transfer(cmd, rsp_payload_len, id)?;
+
+		let (sender, completed_queue) = async_channel::bounded(1);
+		if let Err(err) = transfer_tkn.dispatch_await(sender, false) {
+			// The descriptors may already be visible to the device and
+			// dropping the pending response here would deadlock on the driver
+			// lock, so leak the buffers instead.
+			mem::forget(pending);
+			return Err(err);
+		}
+		self.in_flight.insert(
+			id,
+			InFlightCmd {
+				completed_queue,
+				remaining: 1,
+			},
+		);
+
+		Ok(pending)
+	}
+
+	fn dispatch_command_batch<O: fuse::ops::Op>(
+		&mut self,
+		cmds: Vec<(fuse::Cmd<O>, u32)>,
+	) -> Result<Vec<fuse::PendingRsp<O>>, VirtqError> {
+		let id = self.allocate_id();
+
+		let mut transfer_tkns = Vec::with_capacity(cmds.len());
+		let mut pending = Vec::with_capacity(cmds.len());
+		for (cmd, rsp_payload_len) in cmds {
+			match self.prepare_transfer(cmd, rsp_payload_len, id) {
+				Ok((transfer_tkn, pending_rsp)) => {
+					transfer_tkns.push(transfer_tkn);
+					pending.push(pending_rsp);
+				}
+				Err(err) => {
+					// Dropping the pending responses here would deadlock on
+					// the driver lock, so leak the buffers instead.
+					mem::forget(pending);
+					return Err(err);
+				}
 			}
-		})
+		}
+
+		// Expose the whole batch to the device with a single notification.
+		let remaining = transfer_tkns.len();
+		let (sender, completed_queue) = async_channel::bounded(remaining);
+		if let Err(err) = self.vqueues[1].dispatch_batch_await(transfer_tkns, sender, false) {
+			// The descriptors may already be visible to the device; see
+			// `dispatch_command`.
+			mem::forget(pending);
+			return Err(err);
+		}
+		self.in_flight.insert(
+			id,
+			InFlightCmd {
+				completed_queue,
+				remaining,
+			},
+		);
+
+		Ok(pending)
+	}
+
+	fn poll_completed(&mut self, id: u64) -> bool {
+		// Process the descriptors the device has used and complete their
+		// transfers first.
+		self.vqueues[1].poll();
+
+		let Some(in_flight) = self.in_flight.get_mut(&id) else {
+			// All transfers of the command have already completed.
+			return true;
+		};
+		while in_flight.completed_queue.try_recv().is_ok() {
+			in_flight.remaining -= 1;
+		}
+		if in_flight.remaining > 0 {
+			return false;
+		}
+		self.in_flight.remove(&id);
+
+		true
+	}
+
+	fn allocate_dax_slot(&mut self) -> Option<(u64, usize)> {
+		let window = self.dax_window.as_ref()?;
+		let moffset = self.dax_free_slots.pop()?;
+		Some((moffset, window.as_ptr() as usize + moffset as usize))
+	}
+
+	fn free_dax_slot(&mut self, moffset: u64) {
+		self.dax_free_slots.push(moffset);
 	}
 
 	fn get_mount_point(&self) -> String {
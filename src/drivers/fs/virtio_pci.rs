@@ -1,3 +1,4 @@
+use alloc::collections::BTreeMap;
 use alloc::vec::Vec;
 
 use volatile::VolatileRef;
@@ -71,6 +72,10 @@ impl VirtioFsDriver {
 			}
 		};
 
+		// Shared memory region 0 of a virtio-fs device is the DAX window,
+		// into which file ranges can be mapped for direct access.
+		let dax_window = caps_coll.get_sh_mem_cfg().filter(|cfg| cfg.id() == 0);
+
 		Ok(VirtioFsDriver {
 			dev_cfg,
 			com_cfg,
@@ -78,6 +83,10 @@ impl VirtioFsDriver {
 			notif_cfg,
 			vqueues: Vec::new(),
 			irq: device.get_irq().unwrap(),
+			in_flight: BTreeMap::new(),
+			next_id: 0,
+			dax_window,
+			dax_free_slots: Vec::new(),
 		})
 	}
 
@@ -27,6 +27,12 @@ pub(crate) trait NetworkDriver {
 	fn get_checksums(&self) -> ChecksumCapabilities {
 		ChecksumCapabilities::default()
 	}
+	/// Returns true, if the device segments outgoing TCP packets itself
+	/// (TCP segmentation offload), so the stack may hand over frames
+	/// larger than the MTU.
+	fn has_tso(&self) -> bool {
+		false
+	}
 	/// Returns the mac address of the device.
 	fn get_mac_address(&self) -> [u8; 6];
 	/// Returns the current MTU of the device.
@@ -55,6 +61,12 @@ fn _irqhandler() -> bool {
 		false
 	};
 
+	if result {
+		// The device has received packets, so the interface has to be
+		// polled again, even if its poll deadline has not passed yet.
+		crate::executor::network::trigger_network_poll();
+	}
+
 	// TODO: do we need it?
 	crate::executor::run();
 
@@ -59,6 +59,9 @@ impl VirtioNetDriver {
 			irq,
 			mtu,
 			checksums: ChecksumCapabilities::default(),
+			polling: false,
+			irq_suppressed: false,
+			idle_polls: 0,
 		})
 	}
 
@@ -19,14 +19,15 @@ use core::mem;
 use align_address::Align;
 use pci_types::InterruptLine;
 use smoltcp::phy::{Checksum, ChecksumCapabilities};
-use smoltcp::wire::{EthernetFrame, Ipv4Packet, Ipv6Packet, ETHERNET_HEADER_LEN};
-use virtio::net::{ConfigVolatileFieldAccess, Hdr, HdrF};
+use smoltcp::wire::{EthernetFrame, Ipv4Packet, Ipv6Packet, TcpPacket, ETHERNET_HEADER_LEN};
+use virtio::net::{ConfigVolatileFieldAccess, Hdr, HdrF, HdrGso};
 use virtio::FeatureBits;
 use volatile::access::ReadOnly;
 use volatile::VolatileRef;
 
 use self::constants::MAX_NUM_VQ;
 use self::error::VirtioNetError;
+use crate::arch::kernel::core_local::core_id;
 #[cfg(not(target_arch = "riscv64"))]
 use crate::arch::kernel::core_local::increment_irq_counter;
 use crate::config::VIRTIO_MAX_QUEUE_SIZE;
@@ -94,6 +95,12 @@ impl RxQueues {
 		let rx_size = if dev_cfg.features.contains(virtio::net::F::MRG_RXBUF) {
 			(1514 + mem::size_of::<Hdr>())
 				.align_up(core::mem::size_of::<crossbeam_utils::CachePadded<u8>>())
+		} else if dev_cfg.features.contains(virtio::net::F::GUEST_TSO4)
+			| dev_cfg.features.contains(virtio::net::F::GUEST_TSO6)
+		{
+			// Without mergeable buffers, every buffer has to be able to hold
+			// a complete coalesced packet. See Virtio specification v1.1 - 5.1.6.3.1
+			65550 + mem::size_of::<Hdr>()
 		} else {
 			dev_cfg.raw.as_ptr().mtu().read().to_ne() as usize + mem::size_of::<Hdr>()
 		};
@@ -183,20 +190,25 @@ pub struct TxQueues {
 	vqs: Vec<Rc<dyn Virtq>>,
 	poll_sender: async_channel::Sender<Box<BufferToken>>,
 	poll_receiver: async_channel::Receiver<Box<BufferToken>>,
-	ready_queue: Vec<BufferToken>,
+	/// Prepared buffers, one pool per virtqueue in `vqs`.
+	ready_queues: Vec<Vec<Box<BufferToken>>>,
 	/// Indicates, whether the Driver/Device are using multiple
 	/// queues for communication.
 	is_multi: bool,
 }
 
 impl TxQueues {
-	pub fn new(vqs: Vec<Rc<dyn Virtq>>, ready_queue: Vec<BufferToken>, is_multi: bool) -> Self {
+	pub fn new(
+		vqs: Vec<Rc<dyn Virtq>>,
+		ready_queues: Vec<Vec<Box<BufferToken>>>,
+		is_multi: bool,
+	) -> Self {
 		let (poll_sender, poll_receiver) = async_channel::unbounded();
 		Self {
 			vqs,
 			poll_sender,
 			poll_receiver,
-			ready_queue,
+			ready_queues,
 			is_multi,
 		}
 	}
@@ -235,116 +247,113 @@ impl TxQueues {
 	fn add(&mut self, vq: Rc<dyn Virtq>, dev_cfg: &NetDevCfg) {
 		// Safe virtqueue
 		self.vqs.push(vq.clone());
-		if self.vqs.len() == 1 {
-			// Unwrapping is safe, as one virtq will be definitely in the vector.
-			let vq = self.vqs.first().unwrap();
+		self.ready_queues.push(Vec::new());
+		if self.vqs.len() > 1 {
+			self.is_multi = true;
+		}
 
-			if dev_cfg.features.contains(virtio::net::F::GUEST_TSO4)
-				| dev_cfg.features.contains(virtio::net::F::GUEST_TSO6)
-				| dev_cfg.features.contains(virtio::net::F::GUEST_UFO)
-			{
-				// Virtio specification v1.1. - 5.1.6.2 point 5.
-				//      Header and data are added as ONE output descriptor to the transmitvq.
-				//      Hence we are interpreting this, as the fact, that send packets must be inside a single descriptor.
-				// As usize is currently safe as the minimal usize is defined as 16bit in rust.
-				let buff_def = Bytes::new(mem::size_of::<Hdr>() + 65550).unwrap();
-				let spec = BuffSpec::Single(buff_def);
-
-				let num_buff: u16 = vq.size().into();
-
-				for _ in 0..num_buff {
-					self.ready_queue.push(
-						vq.clone()
-							.prep_buffer(Some(spec.clone()), None)
-							.unwrap()
-							.write_seq(Some(&Hdr::default()), None::<&Hdr>)
-							.unwrap(),
-					)
-				}
-			} else {
-				// Virtio specification v1.1. - 5.1.6.2 point 5.
-				//      Header and data are added as ONE output descriptor to the transmitvq.
-				//      Hence we are interpreting this, as the fact, that send packets must be inside a single descriptor.
-				// As usize is currently safe as the minimal usize is defined as 16bit in rust.
-				let buff_def = Bytes::new(
-					mem::size_of::<Hdr>() + dev_cfg.raw.as_ptr().mtu().read().to_ne() as usize,
-				)
-				.unwrap();
-				let spec = BuffSpec::Single(buff_def);
+		// Virtio specification v1.1. - 5.1.6.2 point 5.
+		//      Header and data are added as ONE output descriptor to the transmitvq.
+		//      Hence we are interpreting this, as the fact, that send packets must be inside a single descriptor.
+		// As usize is currently safe as the minimal usize is defined as 16bit in rust.
+		let buff_def = if dev_cfg.features.contains(virtio::net::F::HOST_TSO4)
+			| dev_cfg.features.contains(virtio::net::F::HOST_TSO6)
+			| dev_cfg.features.contains(virtio::net::F::HOST_UFO)
+		{
+			Bytes::new(mem::size_of::<Hdr>() + 65550).unwrap()
+		} else {
+			Bytes::new(mem::size_of::<Hdr>() + dev_cfg.raw.as_ptr().mtu().read().to_ne() as usize)
+				.unwrap()
+		};
+		let spec = BuffSpec::Single(buff_def);
 
-				let num_buff: u16 = vq.size().into();
+		let num_buff: u16 = vq.size().into();
+		let ready_queue = self.ready_queues.last_mut().unwrap();
 
-				for _ in 0..num_buff {
-					self.ready_queue.push(
-						vq.clone()
-							.prep_buffer(Some(spec.clone()), None)
-							.unwrap()
-							.write_seq(Some(&Hdr::default()), None::<&Hdr>)
-							.unwrap(),
-					)
-				}
-			}
-		} else {
-			self.is_multi = true;
-			// Currently we are doing nothing with the additional queues. They are inactive and might be used in the
-			// future
+		for _ in 0..num_buff {
+			ready_queue.push(
+				vq.clone()
+					.prep_buffer(Some(spec.clone()), None)
+					.unwrap()
+					.write_seq(Some(&Hdr::default()), None::<&Hdr>)
+					.unwrap(),
+			)
 		}
 	}
 
-	/// Returns either a buffertoken and the corresponding index of the
-	/// virtqueue it is coming from. (Index in the TxQueues.vqs vector)
+	/// Pops the next token of fitting size from `ready_queue`.
 	///
-	/// OR returns None, if no Buffertoken could be generated
-	fn get_tkn(&mut self, len: usize) -> Option<(BufferToken, usize)> {
-		// Check all ready token, for correct size.
-		// Drop token if not so
-		//
-		// All Tokens inside the ready_queue are coming from the main queue with index 0.
-		while let Some(mut tkn) = self.ready_queue.pop() {
+	/// Tokens which are too small are dropped on the way.
+	fn pop_fitting_tkn(
+		ready_queue: &mut Vec<Box<BufferToken>>,
+		len: usize,
+	) -> Option<Box<BufferToken>> {
+		while let Some(mut tkn) = ready_queue.pop() {
 			let (send_len, _) = tkn.len();
 
 			match send_len.cmp(&len) {
 				Ordering::Less => {}
-				Ordering::Equal => return Some((tkn, 0)),
+				Ordering::Equal => return Some(tkn),
 				Ordering::Greater => {
 					tkn.restr_size(Some(len), None).unwrap();
-					return Some((tkn, 0));
+					return Some(tkn);
 				}
 			}
 		}
 
+		None
+	}
+
+	/// Returns either a buffertoken and the corresponding index of the
+	/// virtqueue it is coming from. (Index in the TxQueues.vqs vector)
+	///
+	/// OR returns None, if no Buffertoken could be generated
+	fn get_tkn(&mut self, len: usize) -> Option<(Box<BufferToken>, usize)> {
+		// Send packets via the virtqueue belonging to the current core,
+		// so cores do not contend for a single device queue.
+		let vq_index = if self.is_multi {
+			core_id() as usize % self.vqs.len()
+		} else {
+			0
+		};
+
+		if let Some(tkn) = Self::pop_fitting_tkn(&mut self.ready_queues[vq_index], len) {
+			return Some((tkn, vq_index));
+		}
+
 		if self.poll_receiver.is_empty() {
 			self.poll();
 		}
 
+		// Route used tokens back into the pool of the virtqueue they belong to.
 		while let Ok(buffer_token) = self.poll_receiver.try_recv() {
-			let mut tkn = buffer_token.reset();
-			let (send_len, _) = tkn.len();
+			let tkn = buffer_token.reset();
+			let index = self
+				.vqs
+				.iter()
+				.position(|vq| Rc::ptr_eq(vq, &tkn.get_vq()))
+				.unwrap();
+			self.ready_queues[index].push(tkn);
+		}
 
-			match send_len.cmp(&len) {
-				Ordering::Less => {}
-				Ordering::Equal => return Some((tkn, 0)),
-				Ordering::Greater => {
-					tkn.restr_size(Some(len), None).unwrap();
-					return Some((tkn, 0));
-				}
-			}
+		if let Some(tkn) = Self::pop_fitting_tkn(&mut self.ready_queues[vq_index], len) {
+			return Some((tkn, vq_index));
 		}
 
 		// As usize is currently safe as the minimal usize is defined as 16bit in rust.
 		let spec = BuffSpec::Single(Bytes::new(len).unwrap());
 
-		match self.vqs[0].clone().prep_buffer(Some(spec), None) {
-			Ok(tkn) => Some((tkn, 0)),
-			Err(_) => {
-				// Here it is possible if multiple queues are enabled to get another buffertoken from them!
-				// Info the queues are disabled upon initialization and should be enabled somehow!
-				None
-			}
+		match self.vqs[vq_index].clone().prep_buffer(Some(spec), None) {
+			Ok(tkn) => Some((tkn, vq_index)),
+			Err(_) => None,
 		}
 	}
 }
 
+/// Number of consecutive empty receive polls after which suppressed
+/// receive interrupts are enabled again.
+const NAPI_IDLE_BUDGET: u32 = 4;
+
 /// Virtio network driver struct.
 ///
 /// Struct allows to control devices virtqueues as also
@@ -364,6 +373,15 @@ pub(crate) struct VirtioNetDriver {
 	pub(super) irq: InterruptLine,
 	pub(super) mtu: u16,
 	pub(super) checksums: ChecksumCapabilities,
+
+	/// Whether the executor has requested polling mode via
+	/// [`set_polling_mode`](NetworkDriver::set_polling_mode).
+	pub(super) polling: bool,
+	/// Whether the driver itself has suppressed receive interrupts because
+	/// packets kept arriving.
+	pub(super) irq_suppressed: bool,
+	/// Number of consecutive empty receive polls since the last packet.
+	pub(super) idle_polls: u32,
 }
 
 impl NetworkDriver for VirtioNetDriver {
@@ -393,6 +411,13 @@ impl NetworkDriver for VirtioNetDriver {
 		self.checksums.clone()
 	}
 
+	/// The stack may only build frames beyond the MTU if the device splits
+	/// them for both IP versions, as smoltcp does not distinguish.
+	fn has_tso(&self) -> bool {
+		self.dev_cfg.features.contains(virtio::net::F::HOST_TSO4)
+			&& self.dev_cfg.features.contains(virtio::net::F::HOST_TSO6)
+	}
+
 	#[allow(dead_code)]
 	fn has_packet(&self) -> bool {
 		self.recv_vqs.poll();
@@ -423,30 +448,31 @@ impl NetworkDriver for VirtioNetDriver {
 				unsafe { core::slice::from_raw_parts_mut(buff_ptr, len) };
 			let result = f(buf_slice);
 
+			let ethernet_frame: smoltcp::wire::EthernetFrame<&[u8]> =
+				EthernetFrame::new_unchecked(buf_slice);
+			let packet_header_len: u16;
+			let protocol;
+			match ethernet_frame.ethertype() {
+				smoltcp::wire::EthernetProtocol::Ipv4 => {
+					let packet = Ipv4Packet::new_unchecked(ethernet_frame.payload());
+					packet_header_len = packet.header_len().into();
+					protocol = Some(packet.next_header());
+				}
+				smoltcp::wire::EthernetProtocol::Ipv6 => {
+					let packet = Ipv6Packet::new_unchecked(ethernet_frame.payload());
+					packet_header_len = packet.header_len().try_into().unwrap();
+					protocol = Some(packet.next_header());
+				}
+				_ => {
+					packet_header_len = 0;
+					protocol = None;
+				}
+			}
+
 			// If a checksum isn't necessary, we have inform the host within the header
 			// see Virtio specification 5.1.6.2
 			if !self.checksums.tcp.tx() || !self.checksums.udp.tx() {
 				header.flags = HdrF::NEEDS_CSUM;
-				let ethernet_frame: smoltcp::wire::EthernetFrame<&[u8]> =
-					EthernetFrame::new_unchecked(buf_slice);
-				let packet_header_len: u16;
-				let protocol;
-				match ethernet_frame.ethertype() {
-					smoltcp::wire::EthernetProtocol::Ipv4 => {
-						let packet = Ipv4Packet::new_unchecked(ethernet_frame.payload());
-						packet_header_len = packet.header_len().into();
-						protocol = Some(packet.next_header());
-					}
-					smoltcp::wire::EthernetProtocol::Ipv6 => {
-						let packet = Ipv6Packet::new_unchecked(ethernet_frame.payload());
-						packet_header_len = packet.header_len().try_into().unwrap();
-						protocol = Some(packet.next_header());
-					}
-					_ => {
-						packet_header_len = 0;
-						protocol = None;
-					}
-				}
 				header.csum_start =
 					(u16::try_from(ETHERNET_HEADER_LEN).unwrap() + packet_header_len).into();
 				header.csum_offset = match protocol {
@@ -457,6 +483,32 @@ impl NetworkDriver for VirtioNetDriver {
 				.into();
 			}
 
+			// Frames larger than the MTU are only handed to the driver if the
+			// device segments outgoing TCP packets itself (see `has_tso`). We
+			// have to tell the device how to split such packets.
+			// see Virtio specification 5.1.6.2
+			if len > usize::from(self.mtu) + ETHERNET_HEADER_LEN
+				&& protocol == Some(smoltcp::wire::IpProtocol::Tcp)
+			{
+				let tcp_header_len = u16::try_from(
+					TcpPacket::new_unchecked(
+						&ethernet_frame.payload()[usize::from(packet_header_len)..],
+					)
+					.header_len(),
+				)
+				.unwrap();
+
+				header.gso_type = match ethernet_frame.ethertype() {
+					smoltcp::wire::EthernetProtocol::Ipv6 => HdrGso::TCPV6,
+					_ => HdrGso::TCPV4,
+				};
+				header.hdr_len = (u16::try_from(ETHERNET_HEADER_LEN).unwrap()
+					+ packet_header_len
+					+ tcp_header_len)
+					.into();
+				header.gso_size = (self.mtu - packet_header_len - tcp_header_len).into();
+			}
+
 			buff_tkn
 				.provide(BufferType::Direct)
 				.dispatch_await(self.send_vqs.poll_sender.clone(), false)
@@ -469,99 +521,36 @@ impl NetworkDriver for VirtioNetDriver {
 	}
 
 	fn receive_packet(&mut self) -> Option<(RxToken, TxToken)> {
-		match self.recv_vqs.get_next() {
-			Some(transfer) => {
-				let transfer = match RxQueues::post_processing(transfer) {
-					Ok(trf) => trf,
-					Err(vnet_err) => {
-						warn!("Post processing failed. Err: {:?}", vnet_err);
-						return None;
-					}
-				};
-
-				let (_, recv_data_opt) = transfer.as_slices().unwrap();
-				let mut recv_data = recv_data_opt.unwrap();
-
-				// If the given length isn't 1, we currently fail.
-				if recv_data.len() == 1 {
-					let mut vec_data: Vec<u8> = Vec::with_capacity(self.mtu.into());
-					let num_buffers = {
-						const HEADER_SIZE: usize = mem::size_of::<Hdr>();
-						let packet = recv_data.pop().unwrap();
-
-						// drop packets with invalid packet size
-						if packet.len() < HEADER_SIZE {
-							transfer
-								.reset()
-								.provide(BufferType::Direct)
-								.dispatch_await(self.recv_vqs.poll_sender.clone(), false)
-								.unwrap();
-
-							return None;
-						}
-
-						let header = unsafe {
-							core::mem::transmute::<[u8; HEADER_SIZE], Hdr>(
-								packet[..HEADER_SIZE].try_into().unwrap(),
-							)
-						};
-						trace!("Header: {:?}", header);
-						let num_buffers = header.num_buffers;
-
-						vec_data.extend_from_slice(&packet[mem::size_of::<Hdr>()..]);
-						transfer
-							.reset()
-							.provide(BufferType::Direct)
-							.dispatch_await(self.recv_vqs.poll_sender.clone(), false)
-							.unwrap();
-
-						num_buffers
-					};
-
-					for _ in 1..num_buffers.to_ne() {
-						let transfer =
-							match RxQueues::post_processing(self.recv_vqs.get_next().unwrap()) {
-								Ok(trf) => trf,
-								Err(vnet_err) => {
-									warn!("Post processing failed. Err: {:?}", vnet_err);
-									return None;
-								}
-							};
-
-						let (_, recv_data_opt) = transfer.as_slices().unwrap();
-						let mut recv_data = recv_data_opt.unwrap();
-						let packet = recv_data.pop().unwrap();
-						vec_data.extend_from_slice(packet);
-						transfer
-							.reset()
-							.provide(BufferType::Direct)
-							.dispatch_await(self.recv_vqs.poll_sender.clone(), false)
-							.unwrap();
-					}
-
-					Some((RxToken::new(vec_data), TxToken::new()))
-				} else {
-					error!("Empty transfer, or with wrong buffer layout. Reusing and returning error to user-space network driver...");
-					transfer
-						.reset()
-						.write_seq(None::<&Hdr>, Some(&Hdr::default()))
-						.unwrap()
-						.provide(BufferType::Direct)
-						.dispatch_await(self.recv_vqs.poll_sender.clone(), false)
-						.unwrap();
-
-					None
-				}
+		let tokens = self.receive_packet_inner();
+
+		if tokens.is_some() {
+			self.idle_polls = 0;
+		} else if self.irq_suppressed && !self.polling {
+			self.idle_polls += 1;
+			if self.idle_polls >= NAPI_IDLE_BUDGET {
+				// The receive queue has stayed empty for the whole idle
+				// budget, so fall back to interrupts.
+				self.enable_interrupts();
+				self.irq_suppressed = false;
+			} else {
+				// Interrupts are still suppressed, so make sure the
+				// interface is polled again.
+				crate::executor::network::trigger_network_poll();
 			}
-			None => None,
 		}
+
+		tokens
 	}
 
 	fn set_polling_mode(&mut self, value: bool) {
+		self.polling = value;
 		if value {
 			self.disable_interrupts();
 		} else {
+			// The caller is about to wait for an interrupt, so any
+			// suppression by the driver ends here as well.
 			self.enable_interrupts();
+			self.irq_suppressed = false;
 		}
 	}
 
@@ -580,6 +569,15 @@ impl NetworkDriver for VirtioNetDriver {
 
 		self.isr_stat.acknowledge();
 
+		if result && !self.polling {
+			// Packets have arrived: suppress further receive interrupts and
+			// let the executor poll the queue until it runs empty for
+			// NAPI_IDLE_BUDGET polls.
+			self.disable_interrupts();
+			self.irq_suppressed = true;
+			self.idle_polls = 0;
+		}
+
 		result
 	}
 }
@@ -668,6 +666,95 @@ impl VirtioNetDriver {
 		self.recv_vqs.enable_notifs();
 	}
 
+	fn receive_packet_inner(&mut self) -> Option<(RxToken, TxToken)> {
+		match self.recv_vqs.get_next() {
+			Some(transfer) => {
+				let transfer = match RxQueues::post_processing(transfer) {
+					Ok(trf) => trf,
+					Err(vnet_err) => {
+						warn!("Post processing failed. Err: {:?}", vnet_err);
+						return None;
+					}
+				};
+
+				let (_, recv_data_opt) = transfer.as_slices().unwrap();
+				let mut recv_data = recv_data_opt.unwrap();
+
+				// If the given length isn't 1, we currently fail.
+				if recv_data.len() == 1 {
+					let mut vec_data: Vec<u8> = Vec::with_capacity(self.mtu.into());
+					let num_buffers = {
+						const HEADER_SIZE: usize = mem::size_of::<Hdr>();
+						let packet = recv_data.pop().unwrap();
+
+						// drop packets with invalid packet size
+						if packet.len() < HEADER_SIZE {
+							transfer
+								.reset()
+								.provide(BufferType::Direct)
+								.dispatch_await(self.recv_vqs.poll_sender.clone(), false)
+								.unwrap();
+
+							return None;
+						}
+
+						let header = unsafe {
+							core::mem::transmute::<[u8; HEADER_SIZE], Hdr>(
+								packet[..HEADER_SIZE].try_into().unwrap(),
+							)
+						};
+						trace!("Header: {:?}", header);
+						let num_buffers = header.num_buffers;
+
+						vec_data.extend_from_slice(&packet[mem::size_of::<Hdr>()..]);
+						transfer
+							.reset()
+							.provide(BufferType::Direct)
+							.dispatch_await(self.recv_vqs.poll_sender.clone(), false)
+							.unwrap();
+
+						num_buffers
+					};
+
+					for _ in 1..num_buffers.to_ne() {
+						let transfer =
+							match RxQueues::post_processing(self.recv_vqs.get_next().unwrap()) {
+								Ok(trf) => trf,
+								Err(vnet_err) => {
+									warn!("Post processing failed. Err: {:?}", vnet_err);
+									return None;
+								}
+							};
+
+						let (_, recv_data_opt) = transfer.as_slices().unwrap();
+						let mut recv_data = recv_data_opt.unwrap();
+						let packet = recv_data.pop().unwrap();
+						vec_data.extend_from_slice(packet);
+						transfer
+							.reset()
+							.provide(BufferType::Direct)
+							.dispatch_await(self.recv_vqs.poll_sender.clone(), false)
+							.unwrap();
+					}
+
+					Some((RxToken::new(vec_data), TxToken::new()))
+				} else {
+					error!("Empty transfer, or with wrong buffer layout. Reusing and returning error to user-space network driver...");
+					transfer
+						.reset()
+						.write_seq(None::<&Hdr>, Some(&Hdr::default()))
+						.unwrap()
+						.provide(BufferType::Direct)
+						.dispatch_await(self.recv_vqs.poll_sender.clone(), false)
+						.unwrap();
+
+					None
+				}
+			}
+			None => None,
+		}
+	}
+
 	/// Initializes the device in adherence to specification. Returns Some(VirtioNetError)
 	/// upon failure and None in case everything worked as expected.
 	///
@@ -692,6 +779,8 @@ impl VirtioNetDriver {
 			// Packed Vq can be used
 			| virtio::net::F::RING_PACKED
 			| virtio::net::F::NOTIFICATION_DATA
+			// Device notifications can be batched via the ring event indices
+			| virtio::net::F::EVENT_IDX
 			// Host should avoid the creation of checksums
 			| virtio::net::F::CSUM
 			// Guest avoids the creation of checksums
@@ -702,15 +791,18 @@ impl VirtioNetDriver {
 			| virtio::net::F::MRG_RXBUF
 			// the link status can be announced
 			| virtio::net::F::STATUS
+			// device can be controlled at runtime, needed for multiqueue
+			| virtio::net::F::CTRL_VQ
 			// Multiqueue support
-			| virtio::net::F::MQ;
-
-		// Currently the driver does NOT support the features below.
-		// In order to provide functionality for these, the driver
-		// needs to take care of calculating checksum in
-		// RxQueues.post_processing()
-		// | virtio::net::F::GUEST_TSO4
-		// | virtio::net::F::GUEST_TSO6
+			| virtio::net::F::MQ
+			// Device segments outgoing TCP packets (TSO)
+			| virtio::net::F::HOST_TSO4
+			| virtio::net::F::HOST_TSO6
+			// Device may coalesce incoming TCP packets. The partial checksums
+			// of such packets are covered by GUEST_CSUM, as smoltcp does not
+			// verify receive checksums if the feature is negotiated.
+			| virtio::net::F::GUEST_TSO4
+			| virtio::net::F::GUEST_TSO6;
 
 		// Negotiate features with device. Automatically reduces selected feats in order to meet device capabilities.
 		// Aborts in case incompatible features are selected by the driver or the device does not support min_feat_set.
@@ -791,6 +883,13 @@ impl VirtioNetDriver {
 		// At this point the device is "live"
 		self.com_cfg.drv_ok();
 
+		// A multiqueue device only uses the first queue pair until it is told
+		// how many pairs the driver actually drives.
+		// See Virtio specification v1.1. - 5.1.6.5.5
+		if self.dev_cfg.features.contains(virtio::net::F::MQ) && self.num_vqs > 2 {
+			self.set_vq_pairs(self.num_vqs / 2)?;
+		}
+
 		if self.dev_cfg.features.contains(virtio::net::F::CSUM)
 			&& self.dev_cfg.features.contains(virtio::net::F::GUEST_CSUM)
 		{
@@ -838,6 +937,49 @@ impl VirtioNetDriver {
 		}
 	}
 
+	/// Tells the device via the control queue how many virtqueue pairs
+	/// the driver is going to use.
+	///
+	/// See Virtio specification v1.1. - 5.1.6.5.5
+	fn set_vq_pairs(&mut self, num_pairs: u16) -> Result<(), VirtioNetError> {
+		let vq = self
+			.ctrl_vq
+			.0
+			.as_ref()
+			.expect("VIRTIO_NET_F_MQ requires a control queue")
+			.clone();
+
+		// Command layout: class, command and the requested number of queue pairs,
+		// followed by a one byte acknowledgement from the device.
+		let mut cmd = [0u8; 4];
+		cmd[0] = virtio::net::Ctrl::Mq.into();
+		cmd[1] = virtio::net::ctrl::Mq::VqPairsSet.into();
+		cmd[2..4].copy_from_slice(&num_pairs.to_le_bytes());
+
+		let send_spec = BuffSpec::Single(Bytes::new(cmd.len()).unwrap());
+		let recv_spec = BuffSpec::Single(Bytes::new(1).unwrap());
+
+		let ack_tkn = vq
+			.prep_buffer(Some(send_spec), Some(recv_spec))
+			.unwrap()
+			.write_seq(Some(&cmd), None::<&u8>)
+			.unwrap()
+			.provide(BufferType::Direct)
+			.dispatch_blocking()
+			.map_err(|_| VirtioNetError::FailFeatureNeg(self.dev_cfg.dev_id))?;
+
+		let (_, ack_opt) = ack_tkn.as_slices().unwrap();
+		let ack = ack_opt.unwrap().pop().unwrap()[0];
+		// VIRTIO_NET_OK == 0
+		if ack == 0 {
+			info!("Virtio network device uses {num_pairs} virtqueue pairs.");
+			Ok(())
+		} else {
+			error!("Virtio network device rejected using {num_pairs} virtqueue pairs!");
+			Err(VirtioNetError::FailFeatureNeg(self.dev_cfg.dev_id))
+		}
+	}
+
 	/// Device Specific initialization according to Virtio specifictation v1.1. - 5.1.5
 	fn dev_spec_init(&mut self) -> Result<(), VirtioNetError> {
 		match self.virtqueue_init() {
@@ -847,13 +989,28 @@ impl VirtioNetDriver {
 
 		// Add a control if feature is negotiated
 		if self.dev_cfg.features.contains(virtio::net::F::CTRL_VQ) {
+			// If VIRTIO_NET_F_MQ is negotiated, the control queue has the fixed
+			// index 2N, where N is the maximal number of queue pairs offered by
+			// the device, independent of how many pairs the driver brings up.
+			// See Virtio specification v1.1. - 5.1.2
+			let ctrl_index = if self.dev_cfg.features.contains(virtio::net::F::MQ) {
+				self.dev_cfg
+					.raw
+					.as_ptr()
+					.max_virtqueue_pairs()
+					.read()
+					.to_ne() * 2
+			} else {
+				2
+			};
+
 			if self.dev_cfg.features.contains(virtio::net::F::RING_PACKED) {
 				self.ctrl_vq = CtrlQueue(Some(Rc::new(
 					PackedVq::new(
 						&mut self.com_cfg,
 						&self.notif_cfg,
 						VqSize::from(VIRTIO_MAX_QUEUE_SIZE),
-						VqIndex::from(self.num_vqs),
+						VqIndex::from(ctrl_index),
 						self.dev_cfg.features.into(),
 					)
 					.unwrap(),
@@ -864,7 +1021,7 @@ impl VirtioNetDriver {
 						&mut self.com_cfg,
 						&self.notif_cfg,
 						VqSize::from(VIRTIO_MAX_QUEUE_SIZE),
-						VqIndex::from(self.num_vqs),
+						VqIndex::from(ctrl_index),
 						self.dev_cfg.features.into(),
 					)
 					.unwrap(),
@@ -888,24 +1045,20 @@ impl VirtioNetDriver {
 		// - the num_queues is found in the ComCfg struct of the device and defines the maximal number
 		// of supported queues.
 		if self.dev_cfg.features.contains(virtio::net::F::MQ) {
-			if self
+			// One queue pair per core is sufficient, as the driver steers
+			// packet processing to the core-local pair.
+			let max_pairs = self
 				.dev_cfg
 				.raw
 				.as_ptr()
 				.max_virtqueue_pairs()
 				.read()
-				.to_ne() * 2 >= MAX_NUM_VQ
-			{
-				self.num_vqs = MAX_NUM_VQ;
-			} else {
-				self.num_vqs = self
-					.dev_cfg
-					.raw
-					.as_ptr()
-					.max_virtqueue_pairs()
-					.read()
-					.to_ne() * 2;
-			}
+				.to_ne()
+				.min(MAX_NUM_VQ / 2);
+			let num_pairs = max_pairs
+				.min(u16::try_from(crate::arch::get_processor_count()).unwrap_or(u16::MAX))
+				.max(1);
+			self.num_vqs = num_pairs * 2;
 		} else {
 			// Minimal number of virtqueues defined in the standard v1.1. - 5.1.5 Step 1
 			self.num_vqs = 2;
@@ -984,7 +1137,7 @@ impl VirtioNetDriver {
 
 pub mod constants {
 	// Configuration constants
-	pub const MAX_NUM_VQ: u16 = 2;
+	pub const MAX_NUM_VQ: u16 = 32;
 }
 
 /// Error module of virtios network driver. Containing the (VirtioNetError)[VirtioNetError]
@@ -99,6 +99,9 @@ impl VirtioNetDriver {
 			irq: device.get_irq().unwrap(),
 			mtu,
 			checksums: ChecksumCapabilities::default(),
+			polling: false,
+			irq_suppressed: false,
+			idle_polls: 0,
 		})
 	}
 
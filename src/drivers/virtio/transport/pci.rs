@@ -260,6 +260,13 @@ impl UniCapsColl {
 	pub fn get_notif_cfg(&mut self) -> Option<NotifCfg> {
 		self.notif_cfg_list.pop()
 	}
+
+	/// Returns the shared memory configuration with the lowest region ID.
+	///
+	/// INFO: This function removes the Capability and returns ownership.
+	pub fn get_sh_mem_cfg(&mut self) -> Option<ShMemCfg> {
+		self.sh_mem_cfg_list.pop()
+	}
 }
 
 /// Wraps a [`CommonCfg`] in order to preserve
@@ -705,6 +712,22 @@ impl ShMemCfg {
 			id: cap.cap.id,
 		})
 	}
+
+	/// Returns the ID of the shared memory region.
+	/// See Virtio specification v1.1. - 4.1.4.7
+	pub fn id(&self) -> u8 {
+		self.id
+	}
+
+	/// Returns a pointer to the mapped shared memory region.
+	pub fn as_ptr(&self) -> *mut u8 {
+		self.sh_mem.ptr
+	}
+
+	/// Returns the length of the shared memory region in bytes.
+	pub fn len(&self) -> usize {
+		self.length.try_into().unwrap()
+	}
 }
 
 /// Defines a shared memory locate at location ptr with a length of len.
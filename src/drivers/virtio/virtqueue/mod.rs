@@ -310,14 +310,14 @@ pub trait Virtq: VirtqPrivate {
 		};
 
 		Ok(TransferToken {
-			buff_tkn: BufferToken {
+			buff_tkn: Box::new(BufferToken {
 				recv_buff,
 				send_buff,
 				vq: self,
 				ret_send: false,
 				ret_recv: false,
 				reusable: false,
-			},
+			}),
 			await_queue: None,
 			ctrl_desc,
 		})
@@ -368,7 +368,7 @@ pub trait Virtq: VirtqPrivate {
 		self: Rc<Self>,
 		send: Option<BuffSpec<'_>>,
 		recv: Option<BuffSpec<'_>>,
-	) -> Result<BufferToken, VirtqError>;
+	) -> Result<Box<BufferToken>, VirtqError>;
 
 	/// The implementation of the method requires constraints that are incompatible with a trait object.
 	/// Because of this, we constrain it to static objects (via Sized) and call it from the implementation
@@ -944,7 +944,11 @@ pub trait AsSliceU8 {
 pub struct TransferToken {
 	/// Must be some in order to prevent drop
 	/// upon reuse.
-	buff_tkn: BufferToken,
+	///
+	/// The token is boxed, so the very same heap allocation can be
+	/// recycled through the await queue instead of reallocating it for
+	/// every finished transfer.
+	buff_tkn: Box<BufferToken>,
 	/// Structure which allows to await Transfers
 	/// If Some, finished TransferTokens will be placed here
 	/// as finished `Transfers`. If None, only the state
@@ -1135,7 +1139,7 @@ impl BufferToken {
 	/// * Resetting the write status inside the MemDescr. -> Allowing to rewrite the buffers
 	/// * Resetting the MemDescr length at initialization. This length might be reduced upon writes
 	///   of the driver or the device.
-	pub fn reset(mut self) -> Self {
+	pub fn reset(mut self: Box<Self>) -> Box<Self> {
 		if let Some(buff) = self.send_buff.as_mut() {
 			buff.reset_write();
 			let mut init_buff_len = 0usize;
@@ -1161,6 +1165,11 @@ impl BufferToken {
 
 // Public interface of BufferToken
 impl BufferToken {
+	/// Returns a reference to the holding virtqueue
+	pub fn get_vq(&self) -> Rc<dyn Virtq> {
+		Rc::clone(&self.vq)
+	}
+
 	/// Restricts the size of a given BufferToken. One must specify either a `new_send_len` or/and `new_recv_len`. If possible
 	/// the function will restrict the respective buffers size to this value. This is especially useful if one has to provide the
 	/// user-space or the device with a buffer and has already a free buffer at hand, which is to large. With this method the user
@@ -1411,7 +1420,7 @@ impl BufferToken {
 	/// The `write()` function does NOT take into account the distinct descriptors of a buffer but treats the buffer as a single continuous
 	/// memory element and as a result writes `T` or `H` as a slice of bytes into this memory.
 	pub fn write<K: AsSliceU8 + ?Sized, H: AsSliceU8 + ?Sized>(
-		mut self,
+		mut self: Box<Self>,
 		send: Option<&K>,
 		recv: Option<&H>,
 		buffer_type: BufferType,
@@ -1486,10 +1495,10 @@ impl BufferToken {
 	/// * Third Write: `write_seq(Some(10 bytes, Some(4 bytes))`:
 	///   * Will result in 10 bytes written to the second buffer descriptor of the send buffer and 4 bytes written to the third buffer descriptor of the recv buffer.
 	pub fn write_seq<K: AsBytes, H: AsBytes + ?Sized>(
-		mut self,
+		mut self: Box<Self>,
 		send_seq: Option<&K>,
 		recv_seq: Option<&H>,
-	) -> Result<Self, VirtqError> {
+	) -> Result<Box<Self>, VirtqError> {
 		if let Some(data) = send_seq {
 			match self.send_buff.as_mut() {
 				Some(buff) => {
@@ -1528,7 +1537,7 @@ impl BufferToken {
 	/// Consumes the [BufferToken] and returns a [TransferToken], that can be used to actually start the transfer.
 	///
 	/// After this call, the buffers are no longer writable.
-	pub fn provide(self, buffer_type: BufferType) -> TransferToken {
+	pub fn provide(self: Box<Self>, buffer_type: BufferType) -> TransferToken {
 		let ctrl_desc = match buffer_type {
 			BufferType::Direct => None,
 			BufferType::Indirect => Some(
@@ -164,7 +164,7 @@ impl DescriptorRing {
 		if let Some(mut tkn) = ctrl.poll_next() {
 			if let Some(queue) = tkn.await_queue.take() {
 				// Place the TransferToken in a Transfer, which will hold ownership of the token
-				queue.try_send(Box::new(tkn.buff_tkn)).unwrap();
+				queue.try_send(tkn.buff_tkn).unwrap();
 			}
 		}
 	}
@@ -347,7 +347,7 @@ impl<'a> ReadCtrl<'a> {
 					send_buff,
 					recv_buff,
 					..
-				} = &mut tkn.buff_tkn;
+				} = &mut *tkn.buff_tkn;
 				(recv_buff.as_mut(), send_buff.as_mut())
 			};
 
@@ -736,6 +736,11 @@ impl Virtq for PackedVq {
 	}
 
 	fn dispatch(&self, tkn: TransferToken, notif: bool) -> Result<(), VirtqError> {
+		crate::instrumentation::tracepoint(
+			crate::instrumentation::TracepointKind::VirtqueueDispatch,
+			u64::from(self.index.0),
+			1,
+		);
 		let next_idx = self.descr_ring.borrow_mut().push(tkn)?;
 
 		if notif {
@@ -821,7 +826,7 @@ impl Virtq for PackedVq {
 			raw: drv_event,
 		});
 
-		let dev_event = DevNotif {
+		let mut dev_event = DevNotif {
 			f_notif_idx: false,
 			raw: dev_event,
 		};
@@ -834,6 +839,7 @@ impl Virtq for PackedVq {
 
 		if features.contains(virtio::F::EVENT_IDX) {
 			drv_event.borrow_mut().f_notif_idx = true;
+			dev_event.enable_notif_specific();
 		}
 
 		vq_handler.enable_queue();
@@ -864,8 +870,8 @@ impl Virtq for PackedVq {
 		self: Rc<Self>,
 		send: Option<BuffSpec<'_>>,
 		recv: Option<BuffSpec<'_>>,
-	) -> Result<BufferToken, VirtqError> {
-		self.prep_buffer_static(send, recv)
+	) -> Result<Box<BufferToken>, VirtqError> {
+		self.prep_buffer_static(send, recv).map(Box::new)
 	}
 
 	fn size(&self) -> VqSize {
@@ -104,6 +104,10 @@ struct DescrRing {
 	read_idx: u16,
 	token_ring: Box<[Option<Box<TransferToken>>]>,
 	mem_pool: MemPool,
+	/// Whether the device and driver negotiated VIRTIO_F_EVENT_IDX. If so,
+	/// notifications are suppressed via the event fields of the rings instead
+	/// of the flags fields.
+	f_notif_idx: bool,
 
 	/// Descriptor Tables
 	///
@@ -266,7 +270,7 @@ impl DescrRing {
 					.unwrap();
 			}
 			if let Some(queue) = tkn.await_queue.take() {
-				queue.try_send(Box::new(tkn.buff_tkn)).unwrap()
+				queue.try_send(tkn.buff_tkn).unwrap()
 			}
 
 			let mut id_ret_idx = u16::try_from(cur_ring_index).unwrap();
@@ -292,21 +296,47 @@ impl DescrRing {
 	}
 
 	fn drv_enable_notif(&mut self) {
-		let mut avail_ring_ref = self.avail_ring_ref();
-		let avail_ring = avail_ring_ref.as_mut_ptr();
-		map_field!(avail_ring.flags).write(0.into());
+		if self.f_notif_idx {
+			// Ask for an interrupt for the next buffer the device uses.
+			let used_event = self.read_idx;
+			let mut avail_ring_ref = self.avail_ring_ref();
+			let avail_ring = avail_ring_ref.as_mut_ptr();
+			AvailRing::event_ptr(avail_ring).write(MaybeUninit::new(used_event.into()));
+		} else {
+			let mut avail_ring_ref = self.avail_ring_ref();
+			let avail_ring = avail_ring_ref.as_mut_ptr();
+			map_field!(avail_ring.flags).write(0.into());
+		}
 	}
 
 	fn drv_disable_notif(&mut self) {
-		let mut avail_ring_ref = self.avail_ring_ref();
-		let avail_ring = avail_ring_ref.as_mut_ptr();
-		map_field!(avail_ring.flags).write(1.into());
+		if self.f_notif_idx {
+			// Park the event index one behind the next used buffer, so the
+			// device will not cross it while we are polling.
+			let used_event = self.read_idx.wrapping_sub(1);
+			let mut avail_ring_ref = self.avail_ring_ref();
+			let avail_ring = avail_ring_ref.as_mut_ptr();
+			AvailRing::event_ptr(avail_ring).write(MaybeUninit::new(used_event.into()));
+		} else {
+			let mut avail_ring_ref = self.avail_ring_ref();
+			let avail_ring = avail_ring_ref.as_mut_ptr();
+			map_field!(avail_ring.flags).write(1.into());
+		}
 	}
 
-	fn dev_is_notif(&self) -> bool {
+	/// Checks whether the device asks to be notified about the available
+	/// buffers published by advancing the available index from `first_idx`
+	/// to `next_idx`.
+	fn dev_wants_notif(&self, next_idx: u16, first_idx: u16) -> bool {
 		let used_ring_ref = self.used_ring_ref();
 		let used_ring = used_ring_ref.as_ptr();
-		map_field!(used_ring.flags).read().to_ne() & 1 == 0
+		if self.f_notif_idx {
+			// See Virtio specification v1.1. - 2.6.10.1
+			let avail_event = UsedRing::event_ptr(used_ring).read().to_ne();
+			next_idx.wrapping_sub(avail_event).wrapping_sub(1) < next_idx.wrapping_sub(first_idx)
+		} else {
+			map_field!(used_ring.flags).read().to_ne() & 1 == 0
+		}
 	}
 }
 
@@ -338,14 +368,50 @@ impl Virtq for SplitVq {
 
 	fn dispatch_batch_await(
 		&self,
-		_tkns: Vec<TransferToken>,
-		_await_queue: super::BufferTokenSender,
-		_notif: bool,
+		mut tkns: Vec<TransferToken>,
+		await_queue: super::BufferTokenSender,
+		notif: bool,
 	) -> Result<(), VirtqError> {
-		unimplemented!()
+		// Zero transfers are not allowed
+		assert!(!tkns.is_empty());
+
+		if notif {
+			// TODO: Check whether the splitvirtquue has notifications for specific descriptors
+			// I believe it does not.
+			unimplemented!();
+		}
+
+		let count = u16::try_from(tkns.len()).unwrap();
+		crate::instrumentation::tracepoint(
+			crate::instrumentation::TracepointKind::VirtqueueDispatch,
+			u64::from(self.index.0),
+			u64::from(count),
+		);
+		let mut ring = self.ring.borrow_mut();
+
+		// Expose the whole batch to the device before deciding about a single
+		// notification for it.
+		let mut next_idx = 0;
+		for mut tkn in tkns.drain(..) {
+			tkn.await_queue = Some(await_queue.clone());
+			next_idx = ring.push(tkn)?;
+		}
+
+		if ring.dev_wants_notif(next_idx, next_idx.wrapping_sub(count)) {
+			let notification_data = NotificationData::new()
+				.with_vqn(self.index.0)
+				.with_next_idx(next_idx);
+			self.notif_ctrl.notify_dev(notification_data);
+		}
+		Ok(())
 	}
 
 	fn dispatch(&self, tkn: TransferToken, notif: bool) -> Result<(), VirtqError> {
+		crate::instrumentation::tracepoint(
+			crate::instrumentation::TracepointKind::VirtqueueDispatch,
+			u64::from(self.index.0),
+			1,
+		);
 		let next_idx = self.ring.borrow_mut().push(tkn)?;
 
 		if notif {
@@ -354,7 +420,11 @@ impl Virtq for SplitVq {
 			unimplemented!();
 		}
 
-		if self.ring.borrow().dev_is_notif() {
+		if self
+			.ring
+			.borrow()
+			.dev_wants_notif(next_idx, next_idx.wrapping_sub(1))
+		{
 			let notification_data = NotificationData::new()
 				.with_vqn(self.index.0)
 				.with_next_idx(next_idx);
@@ -455,6 +525,7 @@ impl Virtq for SplitVq {
 				.collect::<Vec<_>>()
 				.into_boxed_slice(),
 			mem_pool: MemPool::new(size),
+			f_notif_idx: features.contains(virtio::F::EVENT_IDX),
 
 			descr_table_cell,
 			avail_ring_cell,
@@ -492,8 +563,8 @@ impl Virtq for SplitVq {
 		self: Rc<Self>,
 		send: Option<BuffSpec<'_>>,
 		recv: Option<BuffSpec<'_>>,
-	) -> Result<BufferToken, VirtqError> {
-		self.prep_buffer_static(send, recv)
+	) -> Result<Box<BufferToken>, VirtqError> {
+		self.prep_buffer_static(send, recv).map(Box::new)
 	}
 
 	fn size(&self) -> VqSize {
@@ -7,6 +7,7 @@ use hermit_sync::InterruptTicketMutex;
 use rand_chacha::rand_core::{RngCore, SeedableRng};
 use rand_chacha::ChaCha20Rng;
 
+use crate::arch::core_local::core_id;
 use crate::arch::kernel::processor::{get_timer_ticks, seed_entropy};
 use crate::errno::ENOSYS;
 
@@ -23,14 +24,21 @@ struct Pool {
 	last_reseed: u64,
 }
 
-static POOL: InterruptTicketMutex<Option<Pool>> = InterruptTicketMutex::new(None);
+/// The number of independently seeded and locked entropy pools. Every core
+/// draws from the pool matching its ID, so with up to `POOL_COUNT` cores
+/// each pool belongs to exactly one core and its lock is never contended.
+const POOL_COUNT: usize = 128;
+
+#[allow(clippy::declare_interior_mutable_const)]
+const EMPTY_POOL: InterruptTicketMutex<Option<Pool>> = InterruptTicketMutex::new(None);
+static POOLS: [InterruptTicketMutex<Option<Pool>>; POOL_COUNT] = [EMPTY_POOL; POOL_COUNT];
 
 /// Fills `buf` with random data, respecting the options in `flags`.
 ///
 /// Returns the number of bytes written or `-ENOSYS` if the system does not support
 /// random data generation.
 pub fn read(buf: &mut [u8], _flags: Flags) -> isize {
-	let pool = &mut *POOL.lock();
+	let pool = &mut *POOLS[core_id() as usize % POOL_COUNT].lock();
 	let now = get_timer_ticks();
 	let pool = match pool {
 		Some(pool) if now.saturating_sub(pool.last_reseed) <= RESEED_INTERVAL => pool,
@@ -30,29 +30,35 @@ use crate::drivers::pci as hardware;
 pub(crate) struct HermitNet {
 	mtu: u16,
 	checksums: ChecksumCapabilities,
+	tso: bool,
 }
 
 impl HermitNet {
-	pub(crate) const fn new(mtu: u16, checksums: ChecksumCapabilities) -> Self {
-		Self { mtu, checksums }
+	pub(crate) const fn new(mtu: u16, checksums: ChecksumCapabilities, tso: bool) -> Self {
+		Self {
+			mtu,
+			checksums,
+			tso,
+		}
 	}
 }
 
 impl<'a> NetworkInterface<'a> {
 	#[cfg(feature = "dhcpv4")]
 	pub(crate) fn create() -> NetworkState<'a> {
-		let (mtu, mac, checksums) = if let Some(driver) = hardware::get_network_driver() {
+		let (mtu, mac, checksums, tso) = if let Some(driver) = hardware::get_network_driver() {
 			let guard = driver.lock();
 			(
 				guard.get_mtu(),
 				guard.get_mac_address(),
 				guard.get_checksums(),
+				guard.has_tso(),
 			)
 		} else {
 			return NetworkState::InitializationFailed;
 		};
 
-		let mut device = HermitNet::new(mtu, checksums);
+		let mut device = HermitNet::new(mtu, checksums, tso);
 
 		if hermit_var!("HERMIT_IP").is_some() {
 			warn!("A static IP address is specified with the environment variable HERMIT_IP, but the device is configured to use DHCPv4!");
@@ -84,23 +90,25 @@ impl<'a> NetworkInterface<'a> {
 			dhcp_handle,
 			#[cfg(feature = "dns")]
 			dns_handle: None,
+			watchers: Vec::new(),
 		}))
 	}
 
 	#[cfg(not(feature = "dhcpv4"))]
 	pub(crate) fn create() -> NetworkState<'a> {
-		let (mtu, mac, checksums) = if let Some(driver) = hardware::get_network_driver() {
+		let (mtu, mac, checksums, tso) = if let Some(driver) = hardware::get_network_driver() {
 			let guard = driver.lock();
 			(
 				guard.get_mtu(),
 				guard.get_mac_address(),
 				guard.get_checksums(),
+				guard.has_tso(),
 			)
 		} else {
 			return NetworkState::InitializationFailed;
 		};
 
-		let mut device = HermitNet::new(mtu, checksums);
+		let mut device = HermitNet::new(mtu, checksums, tso);
 
 		let myip = Ipv4Address::from_str(hermit_var_or!("HERMIT_IP", "10.0.5.3")).unwrap();
 		let mygw = Ipv4Address::from_str(hermit_var_or!("HERMIT_GATEWAY", "10.0.5.1")).unwrap();
@@ -182,6 +190,7 @@ impl<'a> NetworkInterface<'a> {
 			device,
 			#[cfg(feature = "dns")]
 			dns_handle: Some(dns_handle),
+			watchers: Vec::new(),
 		}))
 	}
 }
@@ -192,8 +201,14 @@ impl Device for HermitNet {
 
 	fn capabilities(&self) -> DeviceCapabilities {
 		let mut cap = DeviceCapabilities::default();
-		cap.max_transmission_unit = self.mtu.into();
-		cap.max_burst_size = Some(65535 / cap.max_transmission_unit);
+		cap.max_transmission_unit = if self.tso {
+			// The device segments outgoing TCP packets itself, so the stack
+			// may build frames up to the maximal size of an offloaded packet.
+			65550
+		} else {
+			self.mtu.into()
+		};
+		cap.max_burst_size = Some((65535 / cap.max_transmission_unit).max(1));
 		cap.checksum = self.checksums.clone();
 		cap
 	}
@@ -10,13 +10,17 @@ use alloc::sync::Arc;
 use alloc::task::Wake;
 use core::future::Future;
 use core::pin::pin;
-use core::sync::atomic::AtomicU32;
+use core::sync::atomic::{AtomicBool, AtomicU32, Ordering};
 use core::task::{Context, Poll, Waker};
 use core::time::Duration;
 
 use crossbeam_utils::Backoff;
 use hermit_sync::without_interrupts;
 #[cfg(any(feature = "tcp", feature = "udp"))]
+use hermit_sync::{Lazy, SpinMutex};
+#[cfg(any(feature = "tcp", feature = "udp"))]
+use smoltcp::phy::ChecksumCapabilities;
+#[cfg(any(feature = "tcp", feature = "udp"))]
 use smoltcp::time::Instant;
 
 use crate::arch::core_local::*;
@@ -27,7 +31,7 @@ use crate::drivers::net::NetworkDriver;
 #[cfg(all(any(feature = "tcp", feature = "udp"), feature = "pci"))]
 use crate::drivers::pci::get_network_driver;
 #[cfg(any(feature = "tcp", feature = "udp"))]
-use crate::executor::network::network_delay;
+use crate::executor::network::{network_delay, next_poll_delay};
 use crate::executor::task::AsyncTask;
 use crate::fd::IoError;
 #[cfg(any(feature = "tcp", feature = "udp"))]
@@ -80,7 +84,7 @@ pub(crate) fn run() {
 	});
 }
 
-/// Spawns a future on the executor.
+/// Spawns a future on the executor of the current core.
 pub(crate) fn spawn<F>(future: F)
 where
 	F: Future<Output = ()> + Send + 'static,
@@ -88,11 +92,77 @@ where
 	without_interrupts(|| async_tasks().push(AsyncTask::new(future)));
 }
 
+/// Spawns a future on the executor of the given core.
+///
+/// Futures that service a device or a connection should be spawned on
+/// the core that handles its interrupts, so that the interrupt
+/// handler's executor poll picks them up and their state stays in that
+/// core's caches.
+#[cfg(all(any(target_arch = "x86_64", target_arch = "riscv64"), feature = "smp"))]
+pub(crate) fn spawn_on<F>(future: F, core_id: crate::scheduler::CoreId)
+where
+	F: Future<Output = ()> + Send + 'static,
+{
+	crate::scheduler::spawn_async_task(AsyncTask::new(future), core_id);
+}
+
 pub fn init() {
+	// Switch the console to buffered mode and drain it from a background
+	// task, so that writers only append to memory. One task drains the
+	// buffer for all cores.
+	static CONSOLE_DRAINER_SPAWNED: AtomicBool = AtomicBool::new(false);
+	if CONSOLE_DRAINER_SPAWNED
+		.compare_exchange(false, true, Ordering::Relaxed, Ordering::Relaxed)
+		.is_ok()
+	{
+		spawn(crate::console::drain());
+		crate::console::enable_buffering();
+	}
+
 	#[cfg(any(feature = "tcp", feature = "udp"))]
 	crate::executor::network::init();
 }
 
+/// Checksum capabilities of the network device. They are cached, since
+/// they do not change after device initialization and reading them
+/// through the driver requires the driver lock.
+#[cfg(any(feature = "tcp", feature = "udp"))]
+static CHECKSUMS: Lazy<ChecksumCapabilities> = Lazy::new(|| {
+	get_network_driver().map_or_else(ChecksumCapabilities::default, |nic| {
+		nic.lock().get_checksums()
+	})
+});
+
+/// Enables or disables the polling mode of the network interface.
+///
+/// The driver enters polling mode as long as at least one task asks for
+/// it. Tracking the requests globally avoids taking the driver lock on
+/// every `block_on`/`poll_on` iteration just to toggle notifications.
+#[cfg(any(feature = "tcp", feature = "udp"))]
+pub(crate) fn set_polling_mode(value: bool) {
+	static IN_POLLING_MODE: SpinMutex<usize> = SpinMutex::new(0);
+
+	let mut guard = IN_POLLING_MODE.lock();
+
+	if value {
+		*guard += 1;
+
+		if *guard == 1 {
+			if let Some(driver) = get_network_driver() {
+				driver.lock().set_polling_mode(value);
+			}
+		}
+	} else {
+		*guard -= 1;
+
+		if *guard == 0 {
+			if let Some(driver) = get_network_driver() {
+				driver.lock().set_polling_mode(value);
+			}
+		}
+	}
+}
+
 #[inline]
 pub(crate) fn now() -> u64 {
 	crate::arch::kernel::systemtime::now_micros()
@@ -103,15 +173,11 @@ pub(crate) fn poll_on<F, T>(future: F, timeout: Option<Duration>) -> Result<T, I
 where
 	F: Future<Output = Result<T, IoError>>,
 {
-	#[cfg(any(feature = "tcp", feature = "udp"))]
-	let nic = get_network_driver();
-
 	// disable network interrupts
 	#[cfg(any(feature = "tcp", feature = "udp"))]
-	let no_retransmission = if let Some(nic) = nic {
-		let mut guard = nic.lock();
-		guard.set_polling_mode(true);
-		guard.get_checksums().tcp.tx()
+	let no_retransmission = if get_network_driver().is_some() {
+		set_polling_mode(true);
+		CHECKSUMS.tcp.tx()
 	} else {
 		true
 	};
@@ -135,8 +201,8 @@ where
 
 			// allow network interrupts
 			#[cfg(any(feature = "tcp", feature = "udp"))]
-			if let Some(nic) = nic {
-				nic.lock().set_polling_mode(false);
+			if get_network_driver().is_some() {
+				set_polling_mode(false);
 			}
 
 			return t;
@@ -154,8 +220,8 @@ where
 
 				// allow network interrupts
 				#[cfg(any(feature = "tcp", feature = "udp"))]
-				if let Some(nic) = nic {
-					nic.lock().set_polling_mode(false);
+				if get_network_driver().is_some() {
+					set_polling_mode(false);
 				}
 
 				return Err(IoError::ETIME);
@@ -169,15 +235,11 @@ pub(crate) fn block_on<F, T>(future: F, timeout: Option<Duration>) -> Result<T,
 where
 	F: Future<Output = Result<T, IoError>>,
 {
-	#[cfg(any(feature = "tcp", feature = "udp"))]
-	let nic = get_network_driver();
-
 	// disable network interrupts
 	#[cfg(any(feature = "tcp", feature = "udp"))]
-	let no_retransmission = if let Some(nic) = nic {
-		let mut guard = nic.lock();
-		guard.set_polling_mode(true);
-		!guard.get_checksums().tcp.tx()
+	let no_retransmission = if get_network_driver().is_some() {
+		set_polling_mode(true);
+		!CHECKSUMS.tcp.tx()
 	} else {
 		true
 	};
@@ -205,8 +267,8 @@ where
 
 			// allow network interrupts
 			#[cfg(any(feature = "tcp", feature = "udp"))]
-			if let Some(nic) = nic {
-				nic.lock().set_polling_mode(false);
+			if get_network_driver().is_some() {
+				set_polling_mode(false);
 			}
 
 			return t;
@@ -224,8 +286,8 @@ where
 
 				// allow network interrupts
 				#[cfg(any(feature = "tcp", feature = "udp"))]
-				if let Some(nic) = nic {
-					nic.lock().set_polling_mode(false);
+				if get_network_driver().is_some() {
+					set_polling_mode(false);
 				}
 
 				return Err(IoError::ETIME);
@@ -234,7 +296,7 @@ where
 
 		#[cfg(any(feature = "tcp", feature = "udp"))]
 		{
-			let delay = network_delay(Instant::from_micros_const(now.try_into().unwrap()))
+			let delay = next_poll_delay(Instant::from_micros_const(now.try_into().unwrap()))
 				.map(|d| d.total_micros());
 
 			if backoff.is_completed() && delay.unwrap_or(10_000_000) > 10_000 {
@@ -247,16 +309,16 @@ where
 				}
 
 				// allow network interrupts
-				if let Some(nic) = nic {
-					nic.lock().set_polling_mode(false);
+				if get_network_driver().is_some() {
+					set_polling_mode(false);
 				}
 
 				// switch to another task
 				task_notify.wait(wakeup_time);
 
 				// restore default values
-				if let Some(nic) = nic {
-					nic.lock().set_polling_mode(true);
+				if get_network_driver().is_some() {
+					set_polling_mode(true);
 				}
 				backoff.reset();
 			} else {
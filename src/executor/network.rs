@@ -1,12 +1,12 @@
 use alloc::boxed::Box;
-#[cfg(feature = "dns")]
+use alloc::sync::{Arc, Weak};
 use alloc::vec::Vec;
 use core::future;
 use core::ops::DerefMut;
-use core::sync::atomic::{AtomicU16, Ordering};
+use core::sync::atomic::{AtomicBool, AtomicU16, AtomicU64, Ordering};
 use core::task::Poll;
 
-use hermit_sync::InterruptTicketMutex;
+use hermit_sync::{InterruptSpinMutex, InterruptTicketMutex};
 use smoltcp::iface::{SocketHandle, SocketSet};
 #[cfg(feature = "dhcpv4")]
 use smoltcp::socket::dhcpv4;
@@ -16,7 +16,7 @@ use smoltcp::socket::dns::{self, GetQueryResultError, QueryHandle};
 use smoltcp::socket::tcp;
 #[cfg(feature = "udp")]
 use smoltcp::socket::udp;
-use smoltcp::socket::AnySocket;
+use smoltcp::socket::{AnySocket, Socket};
 use smoltcp::time::{Duration, Instant};
 #[cfg(feature = "dns")]
 use smoltcp::wire::{DnsQueryType, IpAddress};
@@ -25,9 +25,10 @@ use smoltcp::wire::{IpCidr, Ipv4Address, Ipv4Cidr};
 
 use crate::arch;
 use crate::executor::device::HermitNet;
-use crate::executor::spawn;
+use crate::fd::eventqueue::EventQueueState;
 #[cfg(feature = "dns")]
 use crate::fd::IoError;
+use crate::fd::{FileDescriptor, PollEvent};
 use crate::scheduler::PerCoreSchedulerExt;
 
 pub(crate) enum NetworkState<'a> {
@@ -50,6 +51,33 @@ pub(crate) type Handle = SocketHandle;
 static LOCAL_ENDPOINT: AtomicU16 = AtomicU16::new(0);
 pub(crate) static NIC: InterruptTicketMutex<NetworkState<'_>> =
 	InterruptTicketMutex::new(NetworkState::Missing);
+/// Point in time (in microseconds) when the network interface has to
+/// be polled again for timeouts and retransmissions. Allows the
+/// background task and `block_on` to skip taking the interface lock
+/// as long as there is nothing to do.
+static NEXT_POLL_TIME: AtomicU64 = AtomicU64::new(0);
+
+/// Requests an immediate poll of the network interface, e.g. after the
+/// device received new packets.
+#[inline]
+pub(crate) fn trigger_network_poll() {
+	NEXT_POLL_TIME.store(0, Ordering::Relaxed);
+}
+
+/// Returns the duration until the network interface has to be polled
+/// again, without taking the interface lock.
+///
+/// The value is updated on every [`NetworkInterface::poll_common`] call
+/// and is therefore only a snapshot of the last poll.
+#[inline]
+pub(crate) fn next_poll_delay(timestamp: Instant) -> Option<Duration> {
+	match NEXT_POLL_TIME.load(Ordering::Relaxed) {
+		u64::MAX => None,
+		t => Some(Duration::from_micros(
+			t.saturating_sub(u64::try_from(timestamp.total_micros()).unwrap()),
+		)),
+	}
+}
 
 pub(crate) struct NetworkInterface<'a> {
 	pub(super) iface: smoltcp::iface::Interface,
@@ -59,6 +87,90 @@ pub(crate) struct NetworkInterface<'a> {
 	pub(super) dhcp_handle: SocketHandle,
 	#[cfg(feature = "dns")]
 	pub(super) dns_handle: Option<SocketHandle>,
+	pub(super) watchers: Vec<Watcher>,
+}
+
+/// An edge-triggered readiness watch placed on a socket by an event queue.
+pub(crate) struct Watcher {
+	handle: Handle,
+	fd: FileDescriptor,
+	/// The events the watcher is interested in.
+	interest: PollEvent,
+	/// The interesting events that were ready when the socket was last
+	/// checked; only newly ready ones are reported.
+	last: PollEvent,
+	/// The event queue the watcher reports to.
+	queue: Weak<InterruptSpinMutex<EventQueueState>>,
+}
+
+impl Watcher {
+	pub(crate) fn new(
+		handle: Handle,
+		fd: FileDescriptor,
+		interest: PollEvent,
+		queue: Weak<InterruptSpinMutex<EventQueueState>>,
+	) -> Self {
+		Self {
+			handle,
+			fd,
+			interest,
+			last: PollEvent::empty(),
+			queue,
+		}
+	}
+}
+
+/// Returns the events that operations on a TCP socket would currently not
+/// block on.
+#[cfg(feature = "tcp")]
+fn tcp_readiness(socket: &tcp::Socket<'_>) -> PollEvent {
+	match socket.state() {
+		tcp::State::Closed | tcp::State::Closing | tcp::State::CloseWait => {
+			PollEvent::POLLIN
+				| PollEvent::POLLRDNORM
+				| PollEvent::POLLRDBAND
+				| PollEvent::POLLOUT
+				| PollEvent::POLLWRNORM
+				| PollEvent::POLLWRBAND
+				| PollEvent::POLLHUP
+		}
+		tcp::State::FinWait1 | tcp::State::FinWait2 | tcp::State::TimeWait => PollEvent::POLLHUP,
+		tcp::State::Listen => PollEvent::empty(),
+		_ => {
+			let mut ready = PollEvent::empty();
+
+			if socket.can_recv() {
+				ready.insert(PollEvent::POLLIN | PollEvent::POLLRDNORM | PollEvent::POLLRDBAND);
+			}
+
+			if socket.can_send() {
+				ready.insert(PollEvent::POLLOUT | PollEvent::POLLWRNORM | PollEvent::POLLWRBAND);
+			}
+
+			ready
+		}
+	}
+}
+
+/// Returns the events that operations on a UDP socket would currently not
+/// block on.
+#[cfg(feature = "udp")]
+fn udp_readiness(socket: &udp::Socket<'_>) -> PollEvent {
+	let mut ready = PollEvent::empty();
+
+	if !socket.is_open() {
+		return ready;
+	}
+
+	if socket.can_recv() {
+		ready.insert(PollEvent::POLLIN | PollEvent::POLLRDNORM | PollEvent::POLLRDBAND);
+	}
+
+	if socket.can_send() {
+		ready.insert(PollEvent::POLLOUT | PollEvent::POLLWRNORM | PollEvent::POLLWRBAND);
+	}
+
+	ready
 }
 
 #[cfg(target_arch = "x86_64")]
@@ -98,10 +210,16 @@ pub(crate) fn now() -> Instant {
 
 async fn network_run() {
 	future::poll_fn(|_cx| {
+		let time = now();
+		if u64::try_from(time.total_micros()).unwrap() < NEXT_POLL_TIME.load(Ordering::Relaxed) {
+			// Nothing to do yet => don't fight for the interface lock.
+			return Poll::Pending;
+		}
+
 		if let Some(mut guard) = NIC.try_lock() {
 			match guard.deref_mut() {
 				NetworkState::Initialized(nic) => {
-					nic.poll_common(now());
+					nic.poll_common(time);
 					Poll::Pending
 				}
 				_ => Poll::Ready(()),
@@ -160,7 +278,25 @@ pub(crate) fn init() {
 			.map(|d| crate::arch::processor::get_timer_ticks() + d.total_micros());
 		crate::core_scheduler().add_network_timer(wakeup_time);
 
-		spawn(network_run());
+		// Device interrupts are handled on the boot processor, whose
+		// interrupt handler polls its own executor for received packets.
+		// Keep the interface-servicing future there, so that packets are
+		// processed directly from the interrupt instead of waiting for the
+		// scheduler loop of whichever core ran the initialization. One
+		// instance services the interface for all cores.
+		static NETWORK_RUN_SPAWNED: AtomicBool = AtomicBool::new(false);
+		if NETWORK_RUN_SPAWNED
+			.compare_exchange(false, true, Ordering::Relaxed, Ordering::Relaxed)
+			.is_ok()
+		{
+			#[cfg(all(any(target_arch = "x86_64", target_arch = "riscv64"), feature = "smp"))]
+			crate::executor::spawn_on(network_run(), 0);
+			#[cfg(not(all(
+				any(target_arch = "x86_64", target_arch = "riscv64"),
+				feature = "smp"
+			)))]
+			crate::executor::spawn(network_run());
+		}
 	}
 }
 
@@ -255,6 +391,51 @@ impl<'a> NetworkInterface<'a> {
 				}
 			}
 		};
+
+		// Report newly ready events on the watched sockets to their event
+		// queues. Only edges are reported: an event fires when it becomes
+		// ready, not for as long as it stays ready.
+		if !self.watchers.is_empty() {
+			self.watchers
+				.retain(|watcher| watcher.queue.strong_count() > 0);
+
+			for (handle, socket) in self.sockets.iter() {
+				let ready = match socket {
+					#[cfg(feature = "tcp")]
+					Socket::Tcp(socket) => tcp_readiness(socket),
+					#[cfg(feature = "udp")]
+					Socket::Udp(socket) => udp_readiness(socket),
+					_ => continue,
+				};
+
+				for watcher in self
+					.watchers
+					.iter_mut()
+					.filter(|watcher| watcher.handle == handle)
+				{
+					let interesting = ready & watcher.interest;
+					let edges = interesting & !watcher.last;
+					watcher.last = interesting;
+
+					if edges.is_empty() {
+						continue;
+					}
+
+					if let Some(queue) = watcher.queue.upgrade() {
+						queue.lock().push(watcher.fd, edges);
+					}
+				}
+			}
+		}
+
+		// Publish when the interface has to be polled again, so idle
+		// paths can check the deadline without taking the interface lock.
+		let next_poll_time = self
+			.iface
+			.poll_delay(timestamp, &self.sockets)
+			.map(|d| u64::try_from(timestamp.total_micros()).unwrap() + d.total_micros())
+			.unwrap_or(u64::MAX);
+		NEXT_POLL_TIME.store(next_poll_time, Ordering::Relaxed);
 	}
 
 	pub(crate) fn poll_delay(&mut self, timestamp: Instant) -> Option<Duration> {
@@ -277,6 +458,22 @@ impl<'a> NetworkInterface<'a> {
 		(self.sockets.get_mut(handle), self.iface.context())
 	}
 
+	/// Places a readiness watch on a socket.
+	pub(crate) fn add_watcher(&mut self, watcher: Watcher) {
+		self.watchers.push(watcher);
+	}
+
+	/// Removes the readiness watch the given event queue placed on `fd`.
+	pub(crate) fn remove_watcher(
+		&mut self,
+		fd: FileDescriptor,
+		queue: &Arc<InterruptSpinMutex<EventQueueState>>,
+	) {
+		let queue = Arc::downgrade(queue);
+		self.watchers
+			.retain(|watcher| watcher.fd != fd || !Weak::ptr_eq(&watcher.queue, &queue));
+	}
+
 	pub(crate) fn destroy_socket(&mut self, handle: Handle) {
 		// This deallocates the socket's buffers
 		self.sockets.remove(handle);
@@ -0,0 +1,141 @@
+use alloc::boxed::Box;
+use alloc::collections::vec_deque::VecDeque;
+use alloc::collections::BTreeMap;
+use alloc::sync::Arc;
+use core::future;
+use core::task::{Poll, Waker};
+
+use async_trait::async_trait;
+use hermit_sync::InterruptSpinMutex;
+
+use crate::executor::network::{now, Watcher, NIC};
+use crate::fd::{get_object, FileDescriptor, IoError, ObjectInterface, PollEvent, PollFd};
+
+/// The state of an event queue, shared with the watchers registered at the
+/// network interface.
+#[derive(Debug, Default)]
+pub(crate) struct EventQueueState {
+	/// Ready file descriptors with the events that have fired since they
+	/// were last reported, keyed by descriptor so that repeated edges on the
+	/// same descriptor coalesce into one entry.
+	ready: BTreeMap<FileDescriptor, PollEvent>,
+	/// Tasks waiting for the queue to become non-empty.
+	waiters: VecDeque<Waker>,
+}
+
+impl EventQueueState {
+	/// Records newly ready events for `fd` and wakes the waiting tasks.
+	pub fn push(&mut self, fd: FileDescriptor, events: PollEvent) {
+		*self.ready.entry(fd).or_default() |= events;
+
+		for waker in self.waiters.drain(..) {
+			waker.wake();
+		}
+	}
+}
+
+/// An event-queue object for scalable readiness notification.
+///
+/// Network sockets are registered once together with their interest set and
+/// are watched by [`NetworkInterface::poll_common`] from then on, which
+/// reports events edge-triggered as the sockets become ready. Waiting on the
+/// queue therefore returns only descriptors that have become ready instead
+/// of re-polling every registered descriptor.
+///
+/// Watches do not follow a socket's lifetime: a registered descriptor has to
+/// be removed from the queue before the socket is closed, since its handle
+/// may be reused by a socket created later.
+///
+/// [`NetworkInterface::poll_common`]: crate::executor::network::NetworkInterface::poll_common
+#[derive(Debug, Clone)]
+pub(crate) struct EventQueue {
+	state: Arc<InterruptSpinMutex<EventQueueState>>,
+}
+
+impl EventQueue {
+	pub fn new() -> Self {
+		Self {
+			state: Arc::new(InterruptSpinMutex::new(EventQueueState::default())),
+		}
+	}
+}
+
+#[async_trait]
+impl ObjectInterface for EventQueue {
+	async fn poll(&self, event: PollEvent) -> Result<PollEvent, IoError> {
+		future::poll_fn(|cx| {
+			let mut guard = self.state.lock();
+
+			let mut available = PollEvent::empty();
+			if !guard.ready.is_empty() {
+				available.insert(PollEvent::POLLIN | PollEvent::POLLRDNORM | PollEvent::POLLRDBAND);
+			}
+
+			let ret = event & available;
+			if ret.is_empty() {
+				guard.waiters.push_back(cx.waker().clone());
+				Poll::Pending
+			} else {
+				Poll::Ready(Ok(ret))
+			}
+		})
+		.await
+	}
+
+	fn eventq_add(&self, fd: FileDescriptor, events: PollEvent) -> Result<(), IoError> {
+		let obj = get_object(fd)?;
+		let handle = obj.socket_handle().ok_or(IoError::EINVAL)?;
+
+		let mut guard = NIC.lock();
+		let nic = guard.as_nic_mut().map_err(|_| IoError::EIO)?;
+		nic.add_watcher(Watcher::new(
+			handle,
+			fd,
+			events,
+			Arc::downgrade(&self.state),
+		));
+		// Report the socket's current readiness as its first edge, so that
+		// events from before the registration are not lost.
+		nic.poll_common(now());
+
+		Ok(())
+	}
+
+	fn eventq_del(&self, fd: FileDescriptor) -> Result<(), IoError> {
+		let mut guard = NIC.lock();
+		let nic = guard.as_nic_mut().map_err(|_| IoError::EIO)?;
+		nic.remove_watcher(fd, &self.state);
+		drop(guard);
+
+		self.state.lock().ready.remove(&fd);
+
+		Ok(())
+	}
+
+	async fn eventq_wait(&self, events: &mut [PollFd]) -> Result<usize, IoError> {
+		future::poll_fn(|cx| {
+			let mut guard = self.state.lock();
+
+			if guard.ready.is_empty() {
+				guard.waiters.push_back(cx.waker().clone());
+				return Poll::Pending;
+			}
+
+			let mut count = 0;
+			while count < events.len() {
+				let Some((fd, revents)) = guard.ready.pop_first() else {
+					break;
+				};
+				events[count] = PollFd {
+					fd,
+					events: PollEvent::empty(),
+					revents,
+				};
+				count += 1;
+			}
+
+			Poll::Ready(Ok(count))
+		})
+		.await
+	}
+}
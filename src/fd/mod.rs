@@ -7,15 +7,20 @@ use core::time::Duration;
 
 use async_trait::async_trait;
 use dyn_clone::DynClone;
+use hermit_sync::InterruptSpinMutex;
 #[cfg(any(feature = "tcp", feature = "udp"))]
 use smoltcp::wire::{IpEndpoint, IpListenEndpoint};
 
 use crate::arch::kernel::core_local::core_scheduler;
+#[cfg(any(feature = "tcp", feature = "udp"))]
+use crate::executor::network::Handle;
 use crate::executor::{block_on, poll_on};
 use crate::fs::{DirectoryEntry, FileAttr, SeekWhence};
 
 mod eventfd;
 #[cfg(any(feature = "tcp", feature = "udp"))]
+pub(crate) mod eventqueue;
+#[cfg(any(feature = "tcp", feature = "udp"))]
 pub(crate) mod socket;
 pub(crate) mod stdio;
 
@@ -273,6 +278,24 @@ pub(crate) trait ObjectInterface: Sync + Send + core::fmt::Debug + DynClone {
 		Err(IoError::ENOSYS)
 	}
 
+	/// receive multiple messages from a socket with a single call
+	///
+	/// Returns the length and the source endpoint of every received
+	/// datagram, in the order of the buffers they have been received into.
+	#[cfg(any(feature = "tcp", feature = "udp"))]
+	fn recvmsgs(&self, _bufs: &mut [&mut [u8]]) -> Result<Vec<(usize, IpEndpoint)>, IoError> {
+		Err(IoError::ENOSYS)
+	}
+
+	/// send multiple messages on a socket with a single call
+	///
+	/// Returns the number of datagrams sent, which may be smaller than
+	/// `msgs.len()` if the send buffer fills up.
+	#[cfg(any(feature = "tcp", feature = "udp"))]
+	fn sendmsgs(&self, _msgs: &[(&[u8], IpEndpoint)]) -> Result<usize, IoError> {
+		Err(IoError::ENOSYS)
+	}
+
 	/// shut down part of a full-duplex connection
 	#[cfg(any(feature = "tcp", feature = "udp"))]
 	fn shutdown(&self, _how: i32) -> Result<(), IoError> {
@@ -284,6 +307,115 @@ pub(crate) trait ObjectInterface: Sync + Send + core::fmt::Debug + DynClone {
 	fn ioctl(&self, _cmd: IoCtl, _value: bool) -> Result<(), IoError> {
 		Err(IoError::ENOSYS)
 	}
+
+	/// returns the handle of the underlying network socket, if any
+	#[cfg(any(feature = "tcp", feature = "udp"))]
+	fn socket_handle(&self) -> Option<Handle> {
+		None
+	}
+
+	/// `eventq_add` registers the descriptor `fd` at an event queue with the
+	/// given interest set
+	#[cfg(any(feature = "tcp", feature = "udp"))]
+	fn eventq_add(&self, _fd: FileDescriptor, _events: PollEvent) -> Result<(), IoError> {
+		Err(IoError::EINVAL)
+	}
+
+	/// `eventq_del` removes the descriptor `fd` from an event queue
+	#[cfg(any(feature = "tcp", feature = "udp"))]
+	fn eventq_del(&self, _fd: FileDescriptor) -> Result<(), IoError> {
+		Err(IoError::EINVAL)
+	}
+
+	/// `eventq_wait` waits on an event queue for registered descriptors to
+	/// become ready and fills `events` with them
+	#[cfg(any(feature = "tcp", feature = "udp"))]
+	async fn eventq_wait(&self, _events: &mut [PollFd]) -> Result<usize, IoError> {
+		Err(IoError::EINVAL)
+	}
+}
+
+/// The maximal number of file descriptors in an [`ObjectMap`].
+const OBJECT_MAP_SIZE: usize = 256;
+
+/// A flat mapping between file descriptors and the referenced IO interfaces.
+///
+/// The map is read-mostly: every IO system call resolves its file descriptor
+/// here, while descriptors are only rarely opened or closed. Every slot is
+/// locked individually, so resolving a descriptor is a bounds check and an
+/// uncontended lock acquisition plus the reference count update, and
+/// operations on unrelated descriptors do not contend.
+pub(crate) struct ObjectMap {
+	slots: [InterruptSpinMutex<Option<Arc<dyn ObjectInterface>>>; OBJECT_MAP_SIZE],
+}
+
+impl ObjectMap {
+	pub(crate) fn new() -> Self {
+		#[allow(clippy::declare_interior_mutable_const)]
+		const FREE_SLOT: InterruptSpinMutex<Option<Arc<dyn ObjectInterface>>> =
+			InterruptSpinMutex::new(None);
+		Self {
+			slots: [FREE_SLOT; OBJECT_MAP_SIZE],
+		}
+	}
+
+	fn slot(
+		&self,
+		fd: FileDescriptor,
+	) -> Result<&InterruptSpinMutex<Option<Arc<dyn ObjectInterface>>>, IoError> {
+		usize::try_from(fd)
+			.ok()
+			.and_then(|fd| self.slots.get(fd))
+			.ok_or(IoError::EINVAL)
+	}
+
+	/// Returns the IO interface referenced by the file descriptor.
+	pub(crate) fn get_object(
+		&self,
+		fd: FileDescriptor,
+	) -> Result<Arc<dyn ObjectInterface>, IoError> {
+		self.slot(fd)?.lock().clone().ok_or(IoError::EINVAL)
+	}
+
+	/// Inserts a new IO interface at the lowest unused file descriptor.
+	pub(crate) fn insert_object(
+		&self,
+		obj: Arc<dyn ObjectInterface>,
+	) -> Result<FileDescriptor, IoError> {
+		for (fd, slot) in self.slots.iter().enumerate() {
+			let mut guard = slot.lock();
+			if guard.is_none() {
+				*guard = Some(obj);
+				return Ok(FileDescriptor::try_from(fd).unwrap());
+			}
+		}
+
+		Err(IoError::EOVERFLOW)
+	}
+
+	/// Replaces the IO interface referenced by the file descriptor.
+	pub(crate) fn replace_object(
+		&self,
+		fd: FileDescriptor,
+		obj: Arc<dyn ObjectInterface>,
+	) -> Result<(), IoError> {
+		*self.slot(fd)?.lock() = Some(obj);
+		Ok(())
+	}
+
+	/// Duplicates the IO interface referenced by the file descriptor at the
+	/// lowest unused file descriptor.
+	pub(crate) fn dup_object(&self, fd: FileDescriptor) -> Result<FileDescriptor, IoError> {
+		self.insert_object(self.get_object(fd)?)
+	}
+
+	/// Removes the IO interface referenced by the file descriptor.
+	pub(crate) fn remove_object(
+		&self,
+		fd: FileDescriptor,
+	) -> Result<Arc<dyn ObjectInterface>, IoError> {
+		self.slot(fd)?.lock().take().ok_or(IoError::EINVAL)
+	}
 }
 
 pub(crate) fn read(fd: FileDescriptor, buf: &mut [u8]) -> Result<usize, IoError> {
@@ -341,8 +473,7 @@ async fn poll_fds(fds: &mut [PollFd]) -> Result<u64, IoError> {
 		for i in &mut *fds {
 			let fd = i.fd;
 			i.revents = PollEvent::empty();
-			let mut pinned_obj = core::pin::pin!(core_scheduler().get_object(fd));
-			if let Ready(Ok(obj)) = pinned_obj.as_mut().poll(cx) {
+			if let Ok(obj) = get_object(fd) {
 				let mut pinned = core::pin::pin!(obj.poll(i.events));
 				if let Ready(Ok(e)) = pinned.as_mut().poll(cx) {
 					if !e.is_empty() {
@@ -399,17 +530,63 @@ pub fn poll(fds: &mut [PollFd], timeout: Option<Duration>) -> Result<u64, IoErro
 pub fn eventfd(initval: u64, flags: EventFlags) -> Result<FileDescriptor, IoError> {
 	let obj = self::eventfd::EventFd::new(initval, flags);
 
-	let fd = block_on(core_scheduler().insert_object(Arc::new(obj)), None)?;
+	let fd = insert_object(Arc::new(obj))?;
+
+	Ok(fd)
+}
+
+/// `eventq_create` creates an event-queue object for scalable readiness
+/// notification. Network sockets can be registered at the queue together
+/// with an interest set and readiness events are reported edge-triggered,
+/// so waiting returns only the descriptors that have become ready instead
+/// of re-polling every registered descriptor.
+///
+/// As its return value, `eventq_create` returns a new file descriptor that
+/// can be used to refer to the event queue.
+#[cfg(any(feature = "tcp", feature = "udp"))]
+pub fn eventq_create() -> Result<FileDescriptor, IoError> {
+	let obj = self::eventqueue::EventQueue::new();
+
+	let fd = insert_object(Arc::new(obj))?;
 
 	Ok(fd)
 }
 
+/// Waits on the event queue referenced by `fd` until registered descriptors
+/// become ready and fills `events` with them, returning the number of
+/// entries written.
+#[cfg(any(feature = "tcp", feature = "udp"))]
+pub fn eventq_wait(
+	fd: FileDescriptor,
+	events: &mut [PollFd],
+	timeout: Option<Duration>,
+) -> Result<usize, IoError> {
+	let obj = get_object(fd)?;
+
+	let result = block_on(obj.eventq_wait(events), timeout);
+	if let Err(ref e) = result {
+		if timeout.is_some() {
+			// A return value of zero indicates that the wait timed out
+			if *e == IoError::EAGAIN {
+				return Ok(0);
+			}
+		}
+	}
+
+	result
+}
+
+/// Returns the object map of the current task.
+fn objmap() -> Arc<ObjectMap> {
+	core_scheduler().get_current_task_object_map()
+}
+
 pub(crate) fn get_object(fd: FileDescriptor) -> Result<Arc<dyn ObjectInterface>, IoError> {
-	block_on(core_scheduler().get_object(fd), None)
+	objmap().get_object(fd)
 }
 
 pub(crate) fn insert_object(obj: Arc<dyn ObjectInterface>) -> Result<FileDescriptor, IoError> {
-	block_on(core_scheduler().insert_object(obj), None)
+	objmap().insert_object(obj)
 }
 
 #[allow(dead_code)]
@@ -417,7 +594,7 @@ pub(crate) fn replace_object(
 	fd: FileDescriptor,
 	obj: Arc<dyn ObjectInterface>,
 ) -> Result<(), IoError> {
-	block_on(core_scheduler().replace_object(fd, obj), None)
+	objmap().replace_object(fd, obj)
 }
 
 // The dup system call allocates a new file descriptor that refers
@@ -425,9 +602,9 @@ pub(crate) fn replace_object(
 // file descriptor number is guaranteed to be the lowest-numbered
 // file descriptor that was unused in the calling process.
 pub(crate) fn dup_object(fd: FileDescriptor) -> Result<FileDescriptor, IoError> {
-	block_on(core_scheduler().dup_object(fd), None)
+	objmap().dup_object(fd)
 }
 
 pub(crate) fn remove_object(fd: FileDescriptor) -> Result<Arc<dyn ObjectInterface>, IoError> {
-	block_on(core_scheduler().remove_object(fd), None)
+	objmap().remove_object(fd)
 }
@@ -1,10 +1,15 @@
 use alloc::boxed::Box;
+use alloc::collections::vec_deque::VecDeque;
+use alloc::sync::Arc;
+use alloc::vec::Vec;
 use core::future;
 use core::ops::DerefMut;
 use core::sync::atomic::{AtomicBool, AtomicU16, Ordering};
 use core::task::Poll;
 
 use async_trait::async_trait;
+use crossbeam_utils::atomic::AtomicCell;
+use hermit_sync::InterruptSpinMutex;
 use smoltcp::iface;
 use smoltcp::socket::tcp;
 use smoltcp::time::Duration;
@@ -28,28 +33,49 @@ fn get_ephemeral_port() -> u16 {
 	LOCAL_ENDPOINT.fetch_add(1, Ordering::SeqCst)
 }
 
+/// The maximal number of listening sockets a single [`listen`] call keeps
+/// live simultaneously.
+///
+/// [`listen`]: ObjectInterface::listen
+const MAX_BACKLOG: i32 = 128;
+
 #[derive(Debug)]
 pub struct Socket {
-	handle: Handle,
+	handle: AtomicCell<Handle>,
 	port: AtomicU16,
 	nonblocking: AtomicBool,
 	listen: AtomicBool,
+	/// Whether this object currently is the listener of its port. Cleared
+	/// when an accept succeeds, since the accept caller hands this object
+	/// out as the connection and installs a fresh clone as the listener.
+	is_listener: AtomicBool,
+	/// Additional sockets of the accept backlog, shared across the
+	/// listener generations a socket goes through while accepting.
+	///
+	/// Each entry listens on the socket's port until a connection
+	/// establishes on it, at which point [`async_accept`](Self::async_accept)
+	/// swaps it with the primary handle. Entries can also be established
+	/// connections parked for a later accept, namely previous primary
+	/// handles that were swapped out.
+	backlog: Arc<InterruptSpinMutex<VecDeque<Handle>>>,
 }
 
 impl Socket {
 	pub fn new(handle: Handle) -> Self {
 		Self {
-			handle,
+			handle: AtomicCell::new(handle),
 			port: AtomicU16::new(0),
 			nonblocking: AtomicBool::new(false),
 			listen: AtomicBool::new(false),
+			is_listener: AtomicBool::new(false),
+			backlog: Arc::new(InterruptSpinMutex::new(VecDeque::new())),
 		}
 	}
 
 	fn with<R>(&self, f: impl FnOnce(&mut tcp::Socket<'_>) -> R) -> R {
 		let mut guard = NIC.lock();
 		let nic = guard.as_nic_mut().unwrap();
-		let result = f(nic.get_mut_socket::<tcp::Socket<'_>>(self.handle));
+		let result = f(nic.get_mut_socket::<tcp::Socket<'_>>(self.handle.load()));
 		nic.poll_common(now());
 
 		result
@@ -58,13 +84,47 @@ impl Socket {
 	fn with_context<R>(&self, f: impl FnOnce(&mut tcp::Socket<'_>, &mut iface::Context) -> R) -> R {
 		let mut guard = NIC.lock();
 		let nic = guard.as_nic_mut().unwrap();
-		let (s, cx) = nic.get_socket_and_context::<tcp::Socket<'_>>(self.handle);
+		let (s, cx) = nic.get_socket_and_context::<tcp::Socket<'_>>(self.handle.load());
 		let result = f(s, cx);
 		nic.poll_common(now());
 
 		result
 	}
 
+	/// Makes an established connection from the accept backlog the primary
+	/// handle of this socket, if there is one. The previous primary handle
+	/// is handed back to the backlog, where it keeps listening or, if a
+	/// connection has already established on it as well, is parked for a
+	/// later accept.
+	fn take_from_backlog(&self) -> bool {
+		let mut backlog = self.backlog.lock();
+		if backlog.is_empty() {
+			return false;
+		}
+
+		let mut guard = NIC.lock();
+		let nic = guard.as_nic_mut().unwrap();
+		for queued in backlog.iter_mut() {
+			if nic.get_mut_socket::<tcp::Socket<'_>>(*queued).is_active() {
+				*queued = self.handle.swap(*queued);
+				return true;
+			}
+		}
+
+		false
+	}
+
+	/// Registers `waker` on all listening sockets of the accept backlog.
+	fn register_backlog_wakers(&self, waker: &core::task::Waker) {
+		let backlog = self.backlog.lock();
+		let mut guard = NIC.lock();
+		let nic = guard.as_nic_mut().unwrap();
+		for queued in backlog.iter() {
+			nic.get_mut_socket::<tcp::Socket<'_>>(*queued)
+				.register_recv_waker(waker);
+		}
+	}
+
 	async fn async_connect(&self, endpoint: IpEndpoint) -> Result<(), IoError> {
 		self.with_context(|socket, cx| socket.connect(cx, endpoint, get_ephemeral_port()))
 			.map_err(|_| IoError::EIO)?;
@@ -122,6 +182,10 @@ impl Socket {
 
 	async fn async_accept(&self) -> Result<IpEndpoint, IoError> {
 		future::poll_fn(|cx| {
+			if self.take_from_backlog() {
+				return Poll::Ready(());
+			}
+
 			self.with(|socket| match socket.state() {
 				tcp::State::Closed => {
 					let _ = socket.listen(self.port.load(Ordering::Acquire));
@@ -130,6 +194,7 @@ impl Socket {
 				tcp::State::Listen | tcp::State::Established => Poll::Ready(()),
 				_ => {
 					socket.register_recv_waker(cx.waker());
+					self.register_backlog_wakers(cx.waker());
 					Poll::Pending
 				}
 			})
@@ -137,6 +202,10 @@ impl Socket {
 		.await;
 
 		future::poll_fn(|cx| {
+			if self.take_from_backlog() {
+				return Poll::Ready(Ok(()));
+			}
+
 			self.with(|socket| {
 				if socket.is_active() {
 					Poll::Ready(Ok(()))
@@ -148,6 +217,7 @@ impl Socket {
 						| tcp::State::FinWait2 => Poll::Ready(Err(IoError::EIO)),
 						_ => {
 							socket.register_recv_waker(cx.waker());
+							self.register_backlog_wakers(cx.waker());
 							Poll::Pending
 						}
 					}
@@ -158,9 +228,13 @@ impl Socket {
 
 		let mut guard = NIC.lock();
 		let nic = guard.as_nic_mut().map_err(|_| IoError::EIO)?;
-		let socket = nic.get_mut_socket::<tcp::Socket<'_>>(self.handle);
+		let socket = nic.get_mut_socket::<tcp::Socket<'_>>(self.handle.load());
 		socket.set_keep_alive(Some(Duration::from_millis(DEFAULT_KEEP_ALIVE_INTERVAL)));
 
+		// This object now carries the established connection; the clone
+		// taking its place registers itself as the listener.
+		self.is_listener.store(false, Ordering::Relaxed);
+
 		Ok(socket.remote_endpoint().unwrap())
 	}
 }
@@ -359,10 +433,15 @@ impl ObjectInterface for Socket {
 		self.nonblocking.load(Ordering::Acquire)
 	}
 
-	fn listen(&self, _backlog: i32) -> Result<(), IoError> {
+	fn socket_handle(&self) -> Option<Handle> {
+		Some(self.handle.load())
+	}
+
+	fn listen(&self, backlog: i32) -> Result<(), IoError> {
 		self.with(|socket| {
 			if !socket.is_open() {
 				self.listen.store(true, Ordering::Relaxed);
+				self.is_listener.store(true, Ordering::Relaxed);
 				socket
 					.listen(self.port.load(Ordering::Acquire))
 					.map(|_| ())
@@ -370,7 +449,25 @@ impl ObjectInterface for Socket {
 			} else {
 				Err(IoError::EIO)
 			}
-		})
+		})?;
+
+		// Keep additional listening sockets live, so that a burst of
+		// incoming connections can establish in parallel before userspace
+		// gets around to accepting them.
+		let extra = (backlog.clamp(1, MAX_BACKLOG) - 1) as usize;
+		let port = self.port.load(Ordering::Acquire);
+		let mut backlog_handles = self.backlog.lock();
+		while backlog_handles.len() < extra {
+			let mut guard = NIC.lock();
+			let nic = guard.as_nic_mut().map_err(|_| IoError::EIO)?;
+			let handle = nic.create_tcp_handle().map_err(|_| IoError::EIO)?;
+			nic.get_mut_socket::<tcp::Socket<'_>>(handle)
+				.listen(port)
+				.map_err(|_| IoError::EIO)?;
+			backlog_handles.push_back(handle);
+		}
+
+		Ok(())
 	}
 
 	fn setsockopt(&self, opt: SocketOption, optval: bool) -> Result<(), IoError> {
@@ -436,14 +533,17 @@ impl Clone for Socket {
 		drop(guard);
 		let port = self.port.load(Ordering::Acquire);
 		let obj = Self {
-			handle,
+			handle: AtomicCell::new(handle),
 			port: AtomicU16::new(port),
 			nonblocking: AtomicBool::new(self.nonblocking.load(Ordering::Acquire)),
 			listen: AtomicBool::new(false),
+			is_listener: AtomicBool::new(false),
+			// The accept backlog moves on to the next listener generation.
+			backlog: self.backlog.clone(),
 		};
 
 		if port > 0 {
-			let _ = obj.listen(1024);
+			let _ = obj.listen(1);
 		}
 
 		obj
@@ -453,6 +553,28 @@ impl Clone for Socket {
 impl Drop for Socket {
 	fn drop(&mut self) {
 		let _ = block_on(self.async_close(), None);
-		NIC.lock().as_nic_mut().unwrap().destroy_socket(self.handle);
+
+		// Closing the listener ends listening on the port, even though
+		// accepted connections still share the backlog. The last reference
+		// cleans up whatever is left over, e.g. when the listener was
+		// dropped in the short window after an accept succeeded but before
+		// the replacement listener registered itself.
+		//
+		// The backlog lock is always taken before the `NIC` lock, so drain
+		// the handles into a local buffer first.
+		let backlog: Vec<Handle> =
+			if self.is_listener.load(Ordering::Relaxed) || Arc::strong_count(&self.backlog) == 1 {
+				self.backlog.lock().drain(..).collect()
+			} else {
+				Vec::new()
+			};
+
+		let mut guard = NIC.lock();
+		let nic = guard.as_nic_mut().unwrap();
+		nic.destroy_socket(self.handle.load());
+		for handle in backlog {
+			nic.get_mut_socket::<tcp::Socket<'_>>(handle).abort();
+			nic.destroy_socket(handle);
+		}
 	}
 }
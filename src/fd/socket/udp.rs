@@ -1,4 +1,5 @@
 use alloc::boxed::Box;
+use alloc::vec::Vec;
 use core::future;
 use core::ops::DerefMut;
 use core::sync::atomic::{AtomicBool, Ordering};
@@ -108,6 +109,92 @@ impl Socket {
 		})
 		.await
 	}
+
+	/// Sends as many datagrams of the batch as fit into the socket's send
+	/// buffer, with the interface locked once for the whole batch. The
+	/// interface is polled once afterwards, so the batch leaves the device
+	/// as a single burst.
+	async fn async_sendmsgs(&self, msgs: &[(&[u8], IpEndpoint)]) -> Result<usize, IoError> {
+		future::poll_fn(|cx| {
+			self.with(|socket| {
+				if socket.is_open() {
+					let mut sent = 0;
+					while sent < msgs.len() && socket.can_send() {
+						let (buffer, endpoint) = msgs[sent];
+						if socket
+							.send_slice(buffer, UdpMetadata::from(endpoint))
+							.is_err()
+						{
+							return Poll::Ready(Err(IoError::EIO));
+						}
+						sent += 1;
+					}
+
+					if sent > 0 {
+						Poll::Ready(Ok(sent))
+					} else {
+						socket.register_send_waker(cx.waker());
+						Poll::Pending
+					}
+				} else {
+					Poll::Ready(Err(IoError::EIO))
+				}
+			})
+		})
+		.await
+	}
+
+	/// Receives as many pending datagrams as there are buffers, with the
+	/// interface locked once for the whole batch. At least one datagram is
+	/// awaited.
+	async fn async_recvmsgs(
+		&self,
+		bufs: &mut [&mut [u8]],
+	) -> Result<Vec<(usize, IpEndpoint)>, IoError> {
+		future::poll_fn(|cx| {
+			self.with(|socket| {
+				if socket.is_open() {
+					if socket.can_recv() {
+						let mut msgs = Vec::new();
+						// The caller matches the returned entries against the
+						// buffers by index, so only advance to the next buffer
+						// when an entry is pushed.
+						while msgs.len() < bufs.len() {
+							if !socket.can_recv() {
+								break;
+							}
+							let buffer = &mut *bufs[msgs.len()];
+							match socket.recv_slice(buffer) {
+								Ok((len, meta)) => match self.endpoint.load() {
+									Some(ep) if meta.endpoint != ep => {
+										// Discard datagrams from other peers,
+										// like `async_recvfrom` does, and
+										// receive into the same buffer again.
+										buffer[..len].iter_mut().for_each(|x| *x = 0);
+									}
+									_ => msgs.push((len, meta.endpoint)),
+								},
+								_ => return Poll::Ready(Err(IoError::EIO)),
+							}
+						}
+
+						if msgs.is_empty() {
+							socket.register_recv_waker(cx.waker());
+							Poll::Pending
+						} else {
+							Poll::Ready(Ok(msgs))
+						}
+					} else {
+						socket.register_recv_waker(cx.waker());
+						Poll::Pending
+					}
+				} else {
+					Poll::Ready(Err(IoError::EIO))
+				}
+			})
+		})
+		.await
+	}
 }
 
 #[async_trait]
@@ -200,6 +287,49 @@ impl ObjectInterface for Socket {
 		}
 	}
 
+	fn sendmsgs(&self, msgs: &[(&[u8], IpEndpoint)]) -> Result<usize, IoError> {
+		if msgs.is_empty() {
+			return Ok(0);
+		}
+
+		if self.nonblocking.load(Ordering::Acquire) {
+			poll_on(self.async_sendmsgs(msgs), Some(Duration::ZERO.into())).map_err(|x| {
+				if x == IoError::ETIME {
+					IoError::EAGAIN
+				} else {
+					x
+				}
+			})
+		} else {
+			poll_on(self.async_sendmsgs(msgs), None)
+		}
+	}
+
+	fn recvmsgs(&self, bufs: &mut [&mut [u8]]) -> Result<Vec<(usize, IpEndpoint)>, IoError> {
+		if bufs.is_empty() {
+			return Ok(Vec::new());
+		}
+
+		if self.nonblocking.load(Ordering::Acquire) {
+			poll_on(self.async_recvmsgs(bufs), Some(Duration::ZERO.into())).map_err(|x| {
+				if x == IoError::ETIME {
+					IoError::EAGAIN
+				} else {
+					x
+				}
+			})
+		} else {
+			match poll_on(
+				self.async_recvmsgs(bufs),
+				Some(Duration::from_secs(2).into()),
+			) {
+				Err(IoError::ETIME) => block_on(self.async_recvmsgs(bufs), None),
+				Err(x) => Err(x),
+				Ok(x) => Ok(x),
+			}
+		}
+	}
+
 	async fn async_read(&self, buffer: &mut [u8]) -> Result<usize, IoError> {
 		future::poll_fn(|cx| {
 			self.with(|socket| {
@@ -241,6 +371,10 @@ impl ObjectInterface for Socket {
 		}
 	}
 
+	fn socket_handle(&self) -> Option<Handle> {
+		Some(self.handle)
+	}
+
 	fn ioctl(&self, cmd: IoCtl, value: bool) -> Result<(), IoError> {
 		if cmd == IoCtl::NonBlocking {
 			if value {
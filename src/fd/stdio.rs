@@ -7,7 +7,6 @@ use async_trait::async_trait;
 #[cfg(target_arch = "x86_64")]
 use x86::io::*;
 
-use crate::arch;
 #[cfg(any(target_arch = "x86_64", target_arch = "aarch64"))]
 use crate::arch::mm::{paging, VirtAddr};
 use crate::fd::{IoError, ObjectInterface, PollEvent, STDERR_FILENO, STDOUT_FILENO};
@@ -90,7 +89,7 @@ impl ObjectInterface for GenericStdout {
 
 	async fn async_write(&self, buf: &[u8]) -> Result<usize, IoError> {
 		let _guard = IO_LOCK.lock().await;
-		arch::output_message_buf(buf);
+		crate::console::write(buf);
 
 		Ok(buf.len())
 	}
@@ -114,7 +113,7 @@ impl ObjectInterface for GenericStderr {
 
 	async fn async_write(&self, buf: &[u8]) -> Result<usize, IoError> {
 		let _guard = IO_LOCK.lock().await;
-		arch::output_message_buf(buf);
+		crate::console::write(buf);
 
 		Ok(buf.len())
 	}
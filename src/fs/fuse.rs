@@ -1,12 +1,14 @@
 use alloc::borrow::ToOwned;
 use alloc::boxed::Box;
+use alloc::collections::{BTreeMap, VecDeque};
 use alloc::ffi::CString;
 use alloc::string::String;
 use alloc::sync::Arc;
 use alloc::vec::Vec;
-use core::future;
+use core::mem::{ManuallyDrop, MaybeUninit};
 use core::sync::atomic::{AtomicU64, Ordering};
 use core::task::Poll;
+use core::{future, ptr};
 
 use async_lock::Mutex;
 use async_trait::async_trait;
@@ -34,17 +36,60 @@ use crate::time::{time_t, timespec};
 const MAX_READ_LEN: usize = 1024 * 64;
 const MAX_WRITE_LEN: usize = 1024 * 64;
 
+/// Size of a cached block of file data.
+const CACHE_BLOCK_SIZE: usize = MAX_READ_LEN;
+
+/// Number of blocks that are fetched in one batch on a cache miss.
+///
+/// The blocks past the missing one are read ahead, so sequential scans pay
+/// one device round trip per batch instead of one per block.
+const READ_AHEAD_BLOCKS: usize = 4;
+
+/// Maximal number of cached blocks per file handle.
+const MAX_CACHED_BLOCKS: usize = 16;
+
+/// Size of the slots the device's DAX window is carved into.
+///
+/// A file handle maps file ranges of this size into its window slot and
+/// serves reads from it with plain memory loads.
+pub(crate) const DAX_SLOT_SIZE: usize = 2 * 1024 * 1024;
+
 const U64_SIZE: usize = ::core::mem::size_of::<u64>();
 
 const S_IFLNK: u32 = 40960;
 const S_IFMT: u32 = 61440;
 
 pub(crate) trait FuseInterface {
-	fn send_command<O: ops::Op>(
+	/// Enqueues a command on the device queue without waiting for the
+	/// response.
+	fn dispatch_command<O: ops::Op>(
 		&mut self,
 		cmd: Cmd<O>,
 		rsp_payload_len: u32,
-	) -> Result<Rsp<O>, VirtqError>;
+	) -> Result<PendingRsp<O>, VirtqError>;
+
+	/// Enqueues a batch of commands at once, notifying the device only once.
+	///
+	/// All commands of the batch share one in-flight ID and complete as a
+	/// unit.
+	fn dispatch_command_batch<O: ops::Op>(
+		&mut self,
+		cmds: Vec<(Cmd<O>, u32)>,
+	) -> Result<Vec<PendingRsp<O>>, VirtqError>;
+
+	/// Polls the device queue and returns whether the command with the given
+	/// in-flight ID has completed.
+	fn poll_completed(&mut self, id: u64) -> bool;
+
+	/// Reserves a [`DAX_SLOT_SIZE`] slot of the device's DAX window,
+	/// returning its byte offset within the window and its virtual address.
+	///
+	/// Returns `None` if the device offers no DAX window or all slots are
+	/// taken.
+	fn allocate_dax_slot(&mut self) -> Option<(u64, usize)>;
+
+	/// Returns a DAX window slot to the allocator.
+	fn free_dax_slot(&mut self, moffset: u64);
 
 	fn get_mount_point(&self) -> String;
 }
@@ -357,6 +402,91 @@ pub(crate) mod ops {
 		}
 	}
 
+	#[derive(Debug)]
+	pub(crate) struct Getattr;
+
+	impl Op for Getattr {
+		const OP_CODE: fuse_abi::Opcode = fuse_abi::Opcode::Getattr;
+		type InStruct = fuse_abi::GetattrIn;
+		type InPayload = ();
+		type OutStruct = fuse_abi::AttrOut;
+		type OutPayload = ();
+	}
+
+	impl Getattr {
+		pub(crate) fn create(nid: u64, fh: u64) -> (Cmd<Self>, u32) {
+			let cmd = Cmd::new(
+				nid,
+				fuse_abi::GetattrIn {
+					getattr_flags: fuse_abi::GETATTR_FH,
+					fh,
+					..Default::default()
+				},
+			);
+			(cmd, 0)
+		}
+	}
+
+	#[derive(Debug)]
+	pub(crate) struct Setupmapping;
+
+	impl Op for Setupmapping {
+		const OP_CODE: fuse_abi::Opcode = fuse_abi::Opcode::Setupmapping;
+		type InStruct = fuse_abi::SetupmappingIn;
+		type InPayload = ();
+		type OutStruct = fuse_abi::SetupmappingOut;
+		type OutPayload = ();
+	}
+
+	impl Setupmapping {
+		pub(crate) fn create(
+			nid: u64,
+			fh: u64,
+			foffset: u64,
+			len: u64,
+			moffset: u64,
+		) -> (Cmd<Self>, u32) {
+			let cmd = Cmd::new(
+				nid,
+				fuse_abi::SetupmappingIn {
+					fh,
+					foffset,
+					len,
+					flags: fuse_abi::SETUPMAPPING_FLAG_READ,
+					moffset,
+				},
+			);
+			(cmd, 0)
+		}
+	}
+
+	#[derive(Debug)]
+	pub(crate) struct Removemapping;
+
+	impl Op for Removemapping {
+		const OP_CODE: fuse_abi::Opcode = fuse_abi::Opcode::Removemapping;
+		type InStruct = fuse_abi::RemovemappingIn;
+		type InPayload = [u8];
+		type OutStruct = fuse_abi::RemovemappingOut;
+		type OutPayload = ();
+	}
+
+	impl Removemapping {
+		pub(crate) fn create(nid: u64, moffset: u64, len: u64) -> (Cmd<Self>, u32) {
+			let one = fuse_abi::RemovemappingOne { moffset, len };
+			// The list of mappings to remove follows the header as payload.
+			let payload = unsafe {
+				core::slice::from_raw_parts(
+					core::ptr::from_ref(&one).cast::<u8>(),
+					core::mem::size_of::<fuse_abi::RemovemappingOne>(),
+				)
+			};
+			let cmd =
+				Cmd::with_boxed_slice(nid, fuse_abi::RemovemappingIn { count: 1 }, payload.into());
+			(cmd, 0)
+		}
+	}
+
 	#[derive(Debug)]
 	pub(crate) struct Lookup;
 
@@ -502,13 +632,101 @@ pub(crate) struct Rsp<O: ops::Op> {
 	pub payload: Option<Box<[u8]>>,
 }
 
+/// The response of a command that has been dispatched to the device but has
+/// not completed yet.
+pub(crate) struct PendingRsp<O: ops::Op> {
+	/// In-flight ID under which the driver tracks the command.
+	pub id: u64,
+	/// The command owns the buffers the device reads from, which have to stay
+	/// alive until the transfer has completed.
+	pub cmd: Cmd<O>,
+	pub headers: Box<MaybeUninit<RspHeader<O>>>,
+	pub payload: Option<Box<[MaybeUninit<u8>]>>,
+}
+
+impl<O: ops::Op> PendingRsp<O> {
+	/// Converts the pending response into a [`Rsp`].
+	///
+	/// # Safety
+	///
+	/// The command must have completed, i.e. [`FuseInterface::poll_completed`]
+	/// must have returned `true` for [`Self::id`].
+	unsafe fn assume_init(self) -> Rsp<O> {
+		// The transfer has completed, so the buffers may be freed again and
+		// the `Drop` impl, which would wait for the completion, is skipped.
+		let this = ManuallyDrop::new(self);
+		unsafe {
+			drop(ptr::read(&this.cmd));
+			Rsp {
+				headers: ptr::read(&this.headers).assume_init(),
+				payload: ptr::read(&this.payload)
+					.map(|slice| Box::<[MaybeUninit<_>]>::assume_init(slice)),
+			}
+		}
+	}
+}
+
+impl<O: ops::Op> Drop for PendingRsp<O> {
+	fn drop(&mut self) {
+		// The virtqueue transfer references the command and response buffers
+		// by raw pointer until the device has used them. If the pending
+		// response is dropped before its completion, e.g. because the future
+		// awaiting it is dropped on a timeout, busy-wait for the device
+		// before the buffers are freed.
+		if let Some(driver) = get_filesystem_driver() {
+			while !driver.lock().poll_completed(self.id) {
+				core::hint::spin_loop();
+			}
+		}
+	}
+}
+
+/// Sends a command to the filesystem driver and busy-waits for its completion.
+fn send_command<O: ops::Op>(cmd: Cmd<O>, rsp_payload_len: u32) -> Result<Rsp<O>, IoError> {
+	let driver = get_filesystem_driver().ok_or(IoError::ENOSYS)?;
+	let pending = driver.lock().dispatch_command(cmd, rsp_payload_len)?;
+	// The driver lock is not held while waiting, so other cores can dispatch
+	// and complete their own commands in the meantime.
+	while !driver.lock().poll_completed(pending.id) {
+		core::hint::spin_loop();
+	}
+	Ok(unsafe { pending.assume_init() })
+}
+
+/// Sends a command to the filesystem driver and awaits its completion
+/// without blocking the executor.
+async fn send_command_async<O: ops::Op>(
+	cmd: Cmd<O>,
+	rsp_payload_len: u32,
+) -> Result<Rsp<O>, IoError> {
+	let pending = get_filesystem_driver()
+		.ok_or(IoError::ENOSYS)?
+		.lock()
+		.dispatch_command(cmd, rsp_payload_len)?;
+	await_rsp(pending).await
+}
+
+/// Waits for the completion of a dispatched command without blocking the
+/// executor.
+async fn await_rsp<O: ops::Op>(pending: PendingRsp<O>) -> Result<Rsp<O>, IoError> {
+	future::poll_fn(|cx| {
+		let driver = get_filesystem_driver().ok_or(IoError::ENOSYS)?;
+		if driver.lock().poll_completed(pending.id) {
+			Poll::Ready(Ok(()))
+		} else {
+			// The driver has no completion interrupt; wake the waker so that
+			// the executor polls the queue again.
+			cx.waker().wake_by_ref();
+			Poll::Pending
+		}
+	})
+	.await?;
+	Ok(unsafe { pending.assume_init() })
+}
+
 fn lookup(name: CString) -> Option<u64> {
 	let (cmd, rsp_payload_len) = ops::Lookup::create(name);
-	let rsp = get_filesystem_driver()
-		.unwrap()
-		.lock()
-		.send_command(cmd, rsp_payload_len)
-		.ok()?;
+	let rsp = send_command(cmd, rsp_payload_len).ok()?;
 	if rsp.headers.out_header.error == 0 {
 		Some(rsp.headers.op_header.nodeid)
 	} else {
@@ -519,10 +737,7 @@ fn lookup(name: CString) -> Option<u64> {
 fn readlink(nid: u64) -> Result<String, IoError> {
 	let len = MAX_READ_LEN as u32;
 	let (cmd, rsp_payload_len) = ops::Readlink::create(nid, len);
-	let rsp = get_filesystem_driver()
-		.unwrap()
-		.lock()
-		.send_command(cmd, rsp_payload_len)?;
+	let rsp = send_command(cmd, rsp_payload_len)?;
 	let len: usize = if rsp.headers.out_header.len as usize
 		- ::core::mem::size_of::<fuse_abi::OutHeader>()
 		- ::core::mem::size_of::<fuse_abi::ReadlinkOut>()
@@ -538,11 +753,85 @@ fn readlink(nid: u64) -> Result<String, IoError> {
 	Ok(String::from_utf8(rsp.payload.unwrap()[..len].to_vec()).unwrap())
 }
 
+/// A bounded cache of file data blocks, keyed by their byte offset in the
+/// file.
+///
+/// Writes go through to the host immediately; cached blocks they touch are
+/// invalidated. A block shorter than [`CACHE_BLOCK_SIZE`] marks the end of
+/// the file. The cache is private to the file handle, so modifications by
+/// other handles or the host are not reflected in it.
+#[derive(Debug, Default)]
+struct BlockCache {
+	blocks: BTreeMap<u64, Box<[u8]>>,
+	/// Offsets of the cached blocks in least-recently-used order.
+	lru: VecDeque<u64>,
+}
+
+impl BlockCache {
+	/// Returns the cached block at `block_offset` and marks it as most
+	/// recently used.
+	fn lookup(&mut self, block_offset: u64) -> Option<&[u8]> {
+		if !self.blocks.contains_key(&block_offset) {
+			return None;
+		}
+		if let Some(pos) = self.lru.iter().position(|&offset| offset == block_offset) {
+			self.lru.remove(pos);
+			self.lru.push_back(block_offset);
+		}
+		self.blocks.get(&block_offset).map(|block| &block[..])
+	}
+
+	/// Inserts a block, evicting the least recently used blocks beyond the
+	/// memory budget.
+	fn insert(&mut self, block_offset: u64, block: Box<[u8]>) {
+		if self.blocks.insert(block_offset, block).is_none() {
+			self.lru.push_back(block_offset);
+		}
+		while self.blocks.len() > MAX_CACHED_BLOCKS {
+			let evicted = self.lru.pop_front().unwrap();
+			self.blocks.remove(&evicted);
+		}
+	}
+
+	/// Invalidates all blocks that overlap `[start, end)` as well as all
+	/// end-of-file blocks below `end`, whose implied file length is stale
+	/// after a write up to `end`.
+	fn invalidate(&mut self, start: u64, end: u64) {
+		self.blocks.retain(|&block_offset, block| {
+			let overlaps = block_offset < end && block_offset + CACHE_BLOCK_SIZE as u64 > start;
+			let stale_eof = block.len() < CACHE_BLOCK_SIZE && block_offset < end;
+			!overlaps && !stale_eof
+		});
+		let blocks = &self.blocks;
+		self.lru.retain(|offset| blocks.contains_key(offset));
+	}
+}
+
+/// A range of the file that is mapped into the handle's DAX window slot.
+#[derive(Debug)]
+struct DaxMapping {
+	/// Byte offset of the window slot within the DAX window.
+	moffset: u64,
+	/// Virtual address of the window slot.
+	win_addr: usize,
+	/// File offset the slot is mapped at.
+	foffset: u64,
+	/// Length of the mapping, capped by the file size.
+	len: usize,
+	/// Size of the file when the mapping was set up.
+	file_size: u64,
+}
+
 #[derive(Debug)]
 struct FuseFileHandleInner {
 	fuse_nid: Option<u64>,
 	fuse_fh: Option<u64>,
 	offset: usize,
+	cache: BlockCache,
+	dax: Option<DaxMapping>,
+	/// Set when setting up a DAX mapping failed, so further reads do not
+	/// retry on every cache miss.
+	dax_failed: bool,
 }
 
 impl FuseFileHandleInner {
@@ -551,6 +840,9 @@ impl FuseFileHandleInner {
 			fuse_nid: None,
 			fuse_fh: None,
 			offset: 0,
+			cache: BlockCache::default(),
+			dax: None,
+			dax_failed: false,
 		}
 	}
 
@@ -561,10 +853,7 @@ impl FuseFileHandleInner {
 		future::poll_fn(|cx| {
 			if let (Some(nid), Some(fh)) = (self.fuse_nid, self.fuse_fh) {
 				let (cmd, rsp_payload_len) = ops::Poll::create(nid, fh, kh, events);
-				let rsp = get_filesystem_driver()
-					.ok_or(IoError::ENOSYS)?
-					.lock()
-					.send_command(cmd, rsp_payload_len)?;
+				let rsp = send_command(cmd, rsp_payload_len)?;
 
 				if rsp.headers.out_header.error < 0 {
 					Poll::Ready(Err(IoError::EIO))
@@ -589,42 +878,195 @@ impl FuseFileHandleInner {
 		.await
 	}
 
-	fn read(&mut self, buf: &mut [u8]) -> Result<usize, IoError> {
-		let mut len = buf.len();
-		if len > MAX_READ_LEN {
-			debug!("Reading longer than max_read_len: {}", len);
-			len = MAX_READ_LEN;
+	async fn read(&mut self, buf: &mut [u8]) -> Result<usize, IoError> {
+		if buf.is_empty() {
+			return Ok(0);
 		}
-		if let (Some(nid), Some(fh)) = (self.fuse_nid, self.fuse_fh) {
-			let (cmd, rsp_payload_len) =
-				ops::Read::create(nid, fh, len.try_into().unwrap(), self.offset as u64);
-			let rsp = get_filesystem_driver()
-				.ok_or(IoError::ENOSYS)?
+		let (Some(nid), Some(fh)) = (self.fuse_nid, self.fuse_fh) else {
+			debug!("File not open, cannot read!");
+			return Err(IoError::ENOENT);
+		};
+
+		// Serve the read block by block from the cache, fetching missing
+		// blocks from the device along the way.
+		let mut read_len = 0;
+		while read_len < buf.len() {
+			let offset = self.offset as u64;
+
+			// Serve directly from the DAX window when the file range is (or
+			// can be) mapped into it; this is a plain memory copy without a
+			// device round trip.
+			if self.dax_map(nid, fh, offset).await {
+				let dax = self.dax.as_ref().unwrap();
+				if offset >= dax.file_size {
+					// End of file.
+					break;
+				}
+				let pos = (offset - dax.foffset) as usize;
+				let len = core::cmp::min(buf.len() - read_len, dax.len - pos);
+				let window = unsafe {
+					core::slice::from_raw_parts((dax.win_addr as *const u8).add(pos), len)
+				};
+				buf[read_len..read_len + len].copy_from_slice(window);
+				read_len += len;
+				self.offset += len;
+				continue;
+			}
+
+			let block_offset = offset - offset % CACHE_BLOCK_SIZE as u64;
+
+			if self.cache.lookup(block_offset).is_none() {
+				self.fetch_blocks(nid, fh, block_offset).await?;
+			}
+			let Some(block) = self.cache.lookup(block_offset) else {
+				break;
+			};
+
+			let block_pos = (offset - block_offset) as usize;
+			if block_pos >= block.len() {
+				// End of file.
+				break;
+			}
+			let len = core::cmp::min(buf.len() - read_len, block.len() - block_pos);
+			buf[read_len..read_len + len].copy_from_slice(&block[block_pos..block_pos + len]);
+			let at_eof = block.len() < CACHE_BLOCK_SIZE && block_pos + len == block.len();
+			read_len += len;
+			self.offset += len;
+			if at_eof {
+				break;
+			}
+		}
+
+		Ok(read_len)
+	}
+
+	/// Ensures that the handle's DAX mapping covers `offset` or the end of
+	/// the file, setting up a new mapping if necessary.
+	///
+	/// Returns `false` if the device has no DAX window, no slot is free, or
+	/// the mapping failed; the caller then falls back to FUSE read commands.
+	async fn dax_map(&mut self, nid: u64, fh: u64, offset: u64) -> bool {
+		if self.dax_failed {
+			return false;
+		}
+		if let Some(dax) = &self.dax {
+			let end = dax.foffset + dax.len as u64;
+			if offset >= dax.foffset && (offset < end || end >= dax.file_size) {
+				return true;
+			}
+		}
+
+		let foffset = offset - offset % DAX_SLOT_SIZE as u64;
+
+		// The mapping must not extend past the end of the file, since the
+		// host cannot map window pages beyond it.
+		let (cmd, rsp_payload_len) = ops::Getattr::create(nid, fh);
+		let file_size = match send_command_async(cmd, rsp_payload_len).await {
+			Ok(rsp) if rsp.headers.out_header.error == 0 => rsp.headers.op_header.attr.size,
+			_ => {
+				self.dax_failed = true;
+				return false;
+			}
+		};
+		if foffset >= file_size {
+			return false;
+		}
+		let len = core::cmp::min(DAX_SLOT_SIZE as u64, file_size - foffset);
+
+		// Reuse the handle's window slot, replacing its previous mapping, or
+		// reserve a fresh one.
+		let (moffset, win_addr) = match self.dax.take() {
+			Some(dax) => {
+				let (cmd, rsp_payload_len) =
+					ops::Removemapping::create(nid, dax.moffset, dax.len as u64);
+				if send_command_async(cmd, rsp_payload_len).await.is_err() {
+					get_filesystem_driver()
+						.unwrap()
+						.lock()
+						.free_dax_slot(dax.moffset);
+					self.dax_failed = true;
+					return false;
+				}
+				(dax.moffset, dax.win_addr)
+			}
+			None => {
+				let Some(driver) = get_filesystem_driver() else {
+					return false;
+				};
+				let Some(slot) = driver.lock().allocate_dax_slot() else {
+					return false;
+				};
+				slot
+			}
+		};
+
+		let (cmd, rsp_payload_len) = ops::Setupmapping::create(nid, fh, foffset, len, moffset);
+		let mapped = match send_command_async(cmd, rsp_payload_len).await {
+			Ok(rsp) => rsp.headers.out_header.error == 0,
+			Err(_) => false,
+		};
+		if !mapped {
+			get_filesystem_driver()
+				.unwrap()
 				.lock()
-				.send_command(cmd, rsp_payload_len)?;
+				.free_dax_slot(moffset);
+			self.dax_failed = true;
+			return false;
+		}
+
+		self.dax = Some(DaxMapping {
+			moffset,
+			win_addr,
+			foffset,
+			len: len as usize,
+			file_size,
+		});
+
+		true
+	}
+
+	/// Fetches the uncached blocks of the batch starting at `block_offset`
+	/// from the device and inserts them into the cache.
+	///
+	/// The whole batch is pipelined as one virtqueue dispatch with a single
+	/// device notification.
+	async fn fetch_blocks(&mut self, nid: u64, fh: u64, block_offset: u64) -> Result<(), IoError> {
+		let mut offsets = Vec::with_capacity(READ_AHEAD_BLOCKS);
+		let mut cmds = Vec::with_capacity(READ_AHEAD_BLOCKS);
+		for n in 0..READ_AHEAD_BLOCKS as u64 {
+			let offset = block_offset + n * CACHE_BLOCK_SIZE as u64;
+			if self.cache.lookup(offset).is_none() {
+				offsets.push(offset);
+				cmds.push(ops::Read::create(nid, fh, CACHE_BLOCK_SIZE as u32, offset));
+			}
+		}
+
+		let pending = get_filesystem_driver()
+			.ok_or(IoError::ENOSYS)?
+			.lock()
+			.dispatch_command_batch(cmds)?;
+
+		for (offset, pending) in offsets.into_iter().zip(pending) {
+			let rsp = await_rsp(pending).await?;
 			let len: usize = if (rsp.headers.out_header.len as usize)
 				- ::core::mem::size_of::<fuse_abi::OutHeader>()
 				- ::core::mem::size_of::<fuse_abi::ReadOut>()
-				>= len
+				>= CACHE_BLOCK_SIZE
 			{
-				len
+				CACHE_BLOCK_SIZE
 			} else {
 				(rsp.headers.out_header.len as usize)
 					- ::core::mem::size_of::<fuse_abi::OutHeader>()
 					- ::core::mem::size_of::<fuse_abi::ReadOut>()
 			};
-			self.offset += len;
-
-			buf[..len].copy_from_slice(&rsp.payload.unwrap()[..len]);
-
-			Ok(len)
-		} else {
-			debug!("File not open, cannot read!");
-			Err(IoError::ENOENT)
+			self.cache
+				.insert(offset, rsp.payload.unwrap()[..len].into());
 		}
+
+		Ok(())
 	}
 
-	fn write(&mut self, buf: &[u8]) -> Result<usize, IoError> {
+	async fn write(&mut self, buf: &[u8]) -> Result<usize, IoError> {
 		debug!("FUSE write!");
 		let mut truncated_len = buf.len();
 		if truncated_len > MAX_WRITE_LEN {
@@ -639,10 +1081,11 @@ impl FuseFileHandleInner {
 			let truncated_buf = Box::<[u8]>::from(&buf[..truncated_len]);
 			let (cmd, rsp_payload_len) =
 				ops::Write::create(nid, fh, truncated_buf, self.offset as u64);
-			let rsp = get_filesystem_driver()
+			let pending = get_filesystem_driver()
 				.ok_or(IoError::ENOSYS)?
 				.lock()
-				.send_command(cmd, rsp_payload_len)?;
+				.dispatch_command(cmd, rsp_payload_len)?;
+			let rsp = await_rsp(pending).await?;
 
 			if rsp.headers.out_header.error < 0 {
 				return Err(IoError::EIO);
@@ -654,6 +1097,17 @@ impl FuseFileHandleInner {
 			} else {
 				rsp_size.try_into().unwrap()
 			};
+			// The write goes through to the host; drop the cached blocks it
+			// touches so that subsequent reads fetch the new data.
+			self.cache
+				.invalidate(self.offset as u64, (self.offset + rsp_len) as u64);
+			// A DAX mapping shares the host's pages and observes the new data
+			// directly; only the recorded file size can go stale.
+			if let Some(dax) = &mut self.dax {
+				if (self.offset + rsp_len) as u64 > dax.file_size {
+					dax.file_size = (self.offset + rsp_len) as u64;
+				}
+			}
 			self.offset += rsp_len;
 			Ok(rsp_len)
 		} else {
@@ -667,10 +1121,7 @@ impl FuseFileHandleInner {
 
 		if let (Some(nid), Some(fh)) = (self.fuse_nid, self.fuse_fh) {
 			let (cmd, rsp_payload_len) = ops::Lseek::create(nid, fh, offset, whence);
-			let rsp = get_filesystem_driver()
-				.ok_or(IoError::ENOSYS)?
-				.lock()
-				.send_command(cmd, rsp_payload_len)?;
+			let rsp = send_command(cmd, rsp_payload_len)?;
 
 			if rsp.headers.out_header.error < 0 {
 				return Err(IoError::EIO);
@@ -688,13 +1139,17 @@ impl FuseFileHandleInner {
 impl Drop for FuseFileHandleInner {
 	fn drop(&mut self) {
 		if self.fuse_nid.is_some() && self.fuse_fh.is_some() {
+			if let Some(dax) = self.dax.take() {
+				let (cmd, rsp_payload_len) =
+					ops::Removemapping::create(self.fuse_nid.unwrap(), dax.moffset, dax.len as u64);
+				send_command(cmd, rsp_payload_len).ok();
+				if let Some(driver) = get_filesystem_driver() {
+					driver.lock().free_dax_slot(dax.moffset);
+				}
+			}
 			let (cmd, rsp_payload_len) =
 				ops::Release::create(self.fuse_nid.unwrap(), self.fuse_fh.unwrap());
-			get_filesystem_driver()
-				.unwrap()
-				.lock()
-				.send_command(cmd, rsp_payload_len)
-				.unwrap();
+			send_command(cmd, rsp_payload_len).unwrap();
 		}
 	}
 }
@@ -715,11 +1170,11 @@ impl ObjectInterface for FuseFileHandle {
 	}
 
 	async fn async_read(&self, buf: &mut [u8]) -> Result<usize, IoError> {
-		self.0.lock().await.read(buf)
+		self.0.lock().await.read(buf).await
 	}
 
 	async fn async_write(&self, buf: &[u8]) -> Result<usize, IoError> {
-		self.0.lock().await.write(buf)
+		self.0.lock().await.write(buf).await
 	}
 
 	fn lseek(&self, offset: isize, whence: SeekWhence) -> Result<isize, IoError> {
@@ -762,10 +1217,7 @@ impl ObjectInterface for FuseDirectoryHandle {
 		// Flag 0x10000 for O_DIRECTORY might not be necessary
 		let (mut cmd, rsp_payload_len) = ops::Open::create(fuse_nid, 0x10000);
 		cmd.headers.in_header.opcode = fuse_abi::Opcode::Opendir as u32;
-		let rsp = get_filesystem_driver()
-			.ok_or(IoError::ENOSYS)?
-			.lock()
-			.send_command(cmd, rsp_payload_len)?;
+		let rsp = send_command(cmd, rsp_payload_len)?;
 		let fuse_fh = rsp.headers.op_header.fh;
 
 		debug!("FUSE readdir: {path:#?}");
@@ -777,10 +1229,7 @@ impl ObjectInterface for FuseDirectoryHandle {
 		// read content of the directory
 		let (mut cmd, rsp_payload_len) = ops::Read::create(fuse_nid, fuse_fh, len, 0);
 		cmd.headers.in_header.opcode = fuse_abi::Opcode::Readdir as u32;
-		let rsp = get_filesystem_driver()
-			.ok_or(IoError::ENOSYS)?
-			.lock()
-			.send_command(cmd, rsp_payload_len)?;
+		let rsp = send_command(cmd, rsp_payload_len)?;
 
 		let len: usize = if rsp.headers.out_header.len as usize
 			- ::core::mem::size_of::<fuse_abi::OutHeader>()
@@ -824,10 +1273,7 @@ impl ObjectInterface for FuseDirectoryHandle {
 		}
 
 		let (cmd, rsp_payload_len) = ops::Release::create(fuse_nid, fuse_fh);
-		get_filesystem_driver()
-			.unwrap()
-			.lock()
-			.send_command(cmd, rsp_payload_len)?;
+		send_command(cmd, rsp_payload_len)?;
 
 		Ok(entries)
 	}
@@ -895,10 +1341,7 @@ impl VfsNode for FuseDirectory {
 		// Flag 0x10000 for O_DIRECTORY might not be necessary
 		let (mut cmd, rsp_payload_len) = ops::Open::create(fuse_nid, 0x10000);
 		cmd.headers.in_header.opcode = fuse_abi::Opcode::Opendir as u32;
-		let rsp = get_filesystem_driver()
-			.ok_or(IoError::ENOSYS)?
-			.lock()
-			.send_command(cmd, rsp_payload_len)?;
+		let rsp = send_command(cmd, rsp_payload_len)?;
 		let fuse_fh = rsp.headers.op_header.fh;
 
 		debug!("FUSE readdir: {path:#?}");
@@ -910,10 +1353,7 @@ impl VfsNode for FuseDirectory {
 		// read content of the directory
 		let (mut cmd, rsp_payload_len) = ops::Read::create(fuse_nid, fuse_fh, len, 0);
 		cmd.headers.in_header.opcode = fuse_abi::Opcode::Readdir as u32;
-		let rsp = get_filesystem_driver()
-			.ok_or(IoError::ENOSYS)?
-			.lock()
-			.send_command(cmd, rsp_payload_len)?;
+		let rsp = send_command(cmd, rsp_payload_len)?;
 
 		let len: usize = if rsp.headers.out_header.len as usize
 			- ::core::mem::size_of::<fuse_abi::OutHeader>()
@@ -957,10 +1397,7 @@ impl VfsNode for FuseDirectory {
 		}
 
 		let (cmd, rsp_payload_len) = ops::Release::create(fuse_nid, fuse_fh);
-		get_filesystem_driver()
-			.unwrap()
-			.lock()
-			.send_command(cmd, rsp_payload_len)?;
+		send_command(cmd, rsp_payload_len)?;
 
 		Ok(entries)
 	}
@@ -972,10 +1409,7 @@ impl VfsNode for FuseDirectory {
 
 		// Is there a better way to implement this?
 		let (cmd, rsp_payload_len) = ops::Lookup::create(path);
-		let rsp = get_filesystem_driver()
-			.unwrap()
-			.lock()
-			.send_command(cmd, rsp_payload_len)?;
+		let rsp = send_command(cmd, rsp_payload_len)?;
 
 		if rsp.headers.out_header.error != 0 {
 			// TODO: Correct error handling
@@ -1000,10 +1434,7 @@ impl VfsNode for FuseDirectory {
 		debug!("FUSE lstat: {path:#?}");
 
 		let (cmd, rsp_payload_len) = ops::Lookup::create(path);
-		let rsp = get_filesystem_driver()
-			.unwrap()
-			.lock()
-			.send_command(cmd, rsp_payload_len)?;
+		let rsp = send_command(cmd, rsp_payload_len)?;
 
 		let attr = rsp.headers.op_header.attr;
 		Ok(FileAttr::from(attr))
@@ -1020,10 +1451,7 @@ impl VfsNode for FuseDirectory {
 		debug!("FUSE lstat: {path:#?}");
 
 		let (cmd, rsp_payload_len) = ops::Lookup::create(path.clone());
-		let rsp = get_filesystem_driver()
-			.unwrap()
-			.lock()
-			.send_command(cmd, rsp_payload_len)?;
+		let rsp = send_command(cmd, rsp_payload_len)?;
 
 		let attr = FileAttr::from(rsp.headers.op_header.attr);
 		let is_dir = attr.st_mode.contains(AccessPermission::S_IFDIR);
@@ -1058,19 +1486,13 @@ impl VfsNode for FuseDirectory {
 				// 3.FUSE_OPEN(nodeid, O_RDONLY) -> fh
 				let (cmd, rsp_payload_len) =
 					ops::Open::create(file_guard.fuse_nid.unwrap(), opt.bits().try_into().unwrap());
-				let rsp = get_filesystem_driver()
-					.ok_or(IoError::ENOSYS)?
-					.lock()
-					.send_command(cmd, rsp_payload_len)?;
+				let rsp = send_command(cmd, rsp_payload_len)?;
 				file_guard.fuse_fh = Some(rsp.headers.op_header.fh);
 			} else {
 				// Create file (opens implicitly, returns results from both lookup and open calls)
 				let (cmd, rsp_payload_len) =
 					ops::Create::create(path, opt.bits().try_into().unwrap(), mode.bits());
-				let rsp = get_filesystem_driver()
-					.ok_or(IoError::ENOSYS)?
-					.lock()
-					.send_command(cmd, rsp_payload_len)?;
+				let rsp = send_command(cmd, rsp_payload_len)?;
 
 				let inner = rsp.headers.op_header;
 				file_guard.fuse_nid = Some(inner.entry.nodeid);
@@ -1087,10 +1509,7 @@ impl VfsNode for FuseDirectory {
 		let path = self.traversal_path(components);
 
 		let (cmd, rsp_payload_len) = ops::Unlink::create(path);
-		let rsp = get_filesystem_driver()
-			.ok_or(IoError::ENOSYS)?
-			.lock()
-			.send_command(cmd, rsp_payload_len)?;
+		let rsp = send_command(cmd, rsp_payload_len)?;
 		trace!("unlink answer {:?}", rsp);
 
 		Ok(())
@@ -1100,10 +1519,7 @@ impl VfsNode for FuseDirectory {
 		let path = self.traversal_path(components);
 
 		let (cmd, rsp_payload_len) = ops::Rmdir::create(path);
-		let rsp = get_filesystem_driver()
-			.ok_or(IoError::ENOSYS)?
-			.lock()
-			.send_command(cmd, rsp_payload_len)?;
+		let rsp = send_command(cmd, rsp_payload_len)?;
 		trace!("rmdir answer {:?}", rsp);
 
 		Ok(())
@@ -1117,10 +1533,7 @@ impl VfsNode for FuseDirectory {
 		let path = self.traversal_path(components);
 		let (cmd, rsp_payload_len) = ops::Mkdir::create(path, mode.bits());
 
-		let rsp = get_filesystem_driver()
-			.ok_or(IoError::ENOSYS)?
-			.lock()
-			.send_command(cmd, rsp_payload_len)?;
+		let rsp = send_command(cmd, rsp_payload_len)?;
 		if rsp.headers.out_header.error == 0 {
 			Ok(())
 		} else {
@@ -1134,7 +1547,7 @@ pub(crate) fn init() {
 
 	if let Some(driver) = get_filesystem_driver() {
 		let (cmd, rsp_payload_len) = ops::Init::create();
-		let rsp = driver.lock().send_command(cmd, rsp_payload_len).unwrap();
+		let rsp = send_command(cmd, rsp_payload_len).unwrap();
 		trace!("fuse init answer: {:?}", rsp);
 
 		let mount_point = driver.lock().get_mount_point().to_string();
@@ -1144,11 +1557,7 @@ pub(crate) fn init() {
 			// Flag 0x10000 for O_DIRECTORY might not be necessary
 			let (mut cmd, rsp_payload_len) = ops::Open::create(fuse_nid, 0x10000);
 			cmd.headers.in_header.opcode = fuse_abi::Opcode::Opendir as u32;
-			let rsp = get_filesystem_driver()
-				.unwrap()
-				.lock()
-				.send_command(cmd, rsp_payload_len)
-				.unwrap();
+			let rsp = send_command(cmd, rsp_payload_len).unwrap();
 			let fuse_fh = rsp.headers.op_header.fh;
 
 			// Linux seems to allocate a single page to store the dirfile
@@ -1158,11 +1567,7 @@ pub(crate) fn init() {
 			// read content of the directory
 			let (mut cmd, rsp_payload_len) = ops::Read::create(fuse_nid, fuse_fh, len, 0);
 			cmd.headers.in_header.opcode = fuse_abi::Opcode::Readdir as u32;
-			let rsp = get_filesystem_driver()
-				.unwrap()
-				.lock()
-				.send_command(cmd, rsp_payload_len)
-				.unwrap();
+			let rsp = send_command(cmd, rsp_payload_len).unwrap();
 
 			let len: usize = if rsp.headers.out_header.len as usize
 				- ::core::mem::size_of::<fuse_abi::OutHeader>()
@@ -1203,11 +1608,7 @@ pub(crate) fn init() {
 			}
 
 			let (cmd, rsp_payload_len) = ops::Release::create(fuse_nid, fuse_fh);
-			get_filesystem_driver()
-				.unwrap()
-				.lock()
-				.send_command(cmd, rsp_payload_len)
-				.unwrap();
+			send_command(cmd, rsp_payload_len).unwrap();
 
 			// remove predefined directories
 			entries.retain(|x| x != ".");
@@ -1219,11 +1620,7 @@ pub(crate) fn init() {
 			for i in entries {
 				let i_cstr = CString::new(i.clone()).unwrap();
 				let (cmd, rsp_payload_len) = ops::Lookup::create(i_cstr);
-				let rsp = get_filesystem_driver()
-					.unwrap()
-					.lock()
-					.send_command(cmd, rsp_payload_len)
-					.unwrap();
+				let rsp = send_command(cmd, rsp_payload_len).unwrap();
 
 				let attr = rsp.headers.op_header.attr;
 				let attr = FileAttr::from(attr);
@@ -6,6 +6,9 @@ pub(crate) const ROOT_ID: u64 = 1;
 #[allow(dead_code)]
 pub(crate) const GETATTR_FH: u32 = 1 << 0;
 
+pub(crate) const SETUPMAPPING_FLAG_WRITE: u64 = 1 << 0;
+pub(crate) const SETUPMAPPING_FLAG_READ: u64 = 1 << 1;
+
 #[repr(C)]
 #[derive(Debug)]
 pub(crate) struct Dirent {
@@ -99,6 +102,14 @@ pub(crate) struct ReadOut {}
 #[derive(Default, Debug)]
 pub(crate) struct LookupIn {}
 
+#[repr(C)]
+#[derive(Default, Debug)]
+pub(crate) struct GetattrIn {
+	pub getattr_flags: u32,
+	pub dummy: u32,
+	pub fh: u64,
+}
+
 #[repr(C)]
 #[derive(Default, Debug)]
 pub(crate) struct ReadlinkIn {}
@@ -307,6 +318,8 @@ pub(crate) enum Opcode {
 	Readdirplus = 44,
 	Rename2 = 45,
 	Lseek = 46,
+	Setupmapping = 48,
+	Removemapping = 49,
 
 	Setvolname = 61,
 	Getxtimes = 62,
@@ -314,3 +327,34 @@ pub(crate) enum Opcode {
 
 	CuseInit = 4096,
 }
+
+#[repr(C)]
+#[derive(Default, Debug)]
+pub(crate) struct SetupmappingIn {
+	pub fh: u64,
+	pub foffset: u64,
+	pub len: u64,
+	pub flags: u64,
+	pub moffset: u64,
+}
+
+#[repr(C)]
+#[derive(Default, Debug)]
+pub(crate) struct SetupmappingOut {}
+
+#[repr(C)]
+#[derive(Default, Debug)]
+pub(crate) struct RemovemappingIn {
+	pub count: u32,
+}
+
+#[repr(C)]
+#[derive(Default, Debug)]
+pub(crate) struct RemovemappingOne {
+	pub moffset: u64,
+	pub len: u64,
+}
+
+#[repr(C)]
+#[derive(Default, Debug)]
+pub(crate) struct RemovemappingOut {}
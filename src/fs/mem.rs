@@ -105,19 +105,96 @@ impl RomFileInterface {
 	}
 }
 
+/// Size of one extent of a [`RamFileInner`] in bytes.
+const EXTENT_SIZE: usize = 64 * 1024;
+
 #[derive(Debug)]
 pub(crate) struct RamFileInner {
-	pub data: Vec<u8>,
+	/// File content, split into fixed-size extents.
+	///
+	/// Extents never move once allocated, so growing the file only appends
+	/// new extents instead of reallocating and copying the whole content.
+	extents: Vec<Box<[u8]>>,
+	/// Length of the file in bytes.
+	len: usize,
 	pub attr: FileAttr,
 }
 
 impl RamFileInner {
 	pub fn new(attr: FileAttr) -> Self {
 		Self {
-			data: Vec::new(),
+			extents: Vec::new(),
+			len: 0,
 			attr,
 		}
 	}
+
+	pub fn len(&self) -> usize {
+		self.len
+	}
+
+	/// Resizes the file to `new_len` bytes, appending zeroed extents or
+	/// dropping trailing ones as needed.
+	fn resize(&mut self, new_len: usize) {
+		if new_len < self.len {
+			self.extents.truncate(new_len.div_ceil(EXTENT_SIZE));
+			// Zero the now unused tail of the last extent, so that growing
+			// the file again does not resurrect old data. If the new length
+			// is a multiple of the extent size, the last extent is fully in
+			// use and must not be touched.
+			if new_len % EXTENT_SIZE != 0 {
+				if let Some(extent) = self.extents.last_mut() {
+					extent[new_len % EXTENT_SIZE..].fill(0);
+				}
+			}
+		} else {
+			while self.extents.len() * EXTENT_SIZE < new_len {
+				self.extents
+					.push(alloc::vec![0; EXTENT_SIZE].into_boxed_slice());
+			}
+		}
+		self.len = new_len;
+	}
+
+	/// Copies from the file at `offset` into `buf` extent by extent,
+	/// returning the number of bytes copied.
+	fn read_at(&self, offset: usize, buf: &mut [u8]) -> usize {
+		if offset >= self.len {
+			return 0;
+		}
+		let len = core::cmp::min(buf.len(), self.len - offset);
+
+		let mut copied = 0;
+		while copied < len {
+			let pos = offset + copied;
+			let extent = &self.extents[pos / EXTENT_SIZE];
+			let extent_pos = pos % EXTENT_SIZE;
+			let n = core::cmp::min(len - copied, EXTENT_SIZE - extent_pos);
+			buf[copied..copied + n].copy_from_slice(&extent[extent_pos..extent_pos + n]);
+			copied += n;
+		}
+
+		len
+	}
+
+	/// Copies `buf` into the file at `offset` extent by extent, growing the
+	/// file as needed.
+	fn write_at(&mut self, offset: usize, buf: &[u8]) {
+		if offset + buf.len() > self.len {
+			self.resize(offset + buf.len());
+			self.attr.st_size = self.len.try_into().unwrap();
+		}
+
+		let mut copied = 0;
+		while copied < buf.len() {
+			let pos = offset + copied;
+			let extent = &mut self.extents[pos / EXTENT_SIZE];
+			let extent_pos = pos % EXTENT_SIZE;
+			let n = core::cmp::min(buf.len() - copied, EXTENT_SIZE - extent_pos);
+			extent[extent_pos..extent_pos + n].copy_from_slice(&buf[copied..copied + n]);
+			copied += n;
+		}
+	}
 }
 
 #[derive(Debug, Clone)]
@@ -131,7 +208,7 @@ pub struct RamFileInterface {
 #[async_trait]
 impl ObjectInterface for RamFileInterface {
 	async fn poll(&self, event: PollEvent) -> Result<PollEvent, IoError> {
-		let len = self.inner.read().await.data.len();
+		let len = self.inner.read().await.len();
 		let pos = *self.pos.lock().await;
 
 		let mut available = PollEvent::POLLOUT | PollEvent::POLLWRNORM | PollEvent::POLLWRBAND;
@@ -155,17 +232,7 @@ impl ObjectInterface for RamFileInterface {
 		let mut pos_guard = self.pos.lock().await;
 		let pos = *pos_guard;
 
-		if pos >= guard.data.len() {
-			return Ok(0);
-		}
-
-		let len = if guard.data.len() - pos < buf.len() {
-			guard.data.len() - pos
-		} else {
-			buf.len()
-		};
-
-		buf[0..len].clone_from_slice(&guard.data[pos..pos + len]);
+		let len = guard.read_at(pos, buf);
 		*pos_guard = pos + len;
 
 		Ok(len)
@@ -178,16 +245,11 @@ impl ObjectInterface for RamFileInterface {
 		let mut pos_guard = self.pos.lock().await;
 		let pos = *pos_guard;
 
-		if pos + buf.len() > guard.data.len() {
-			guard.data.resize(pos + buf.len(), 0);
-			guard.attr.st_size = guard.data.len().try_into().unwrap();
-		}
-
 		guard.attr.st_atim = t;
 		guard.attr.st_mtim = t;
 		guard.attr.st_ctim = t;
 
-		guard.data[pos..pos + buf.len()].clone_from_slice(buf);
+		guard.write_at(pos, buf);
 		*pos_guard = pos + buf.len();
 
 		Ok(buf.len())
@@ -203,7 +265,7 @@ impl RamFileInterface {
 	}
 
 	pub fn len(&self) -> usize {
-		block_on(async { Ok(self.inner.read().await.data.len()) }, None).unwrap()
+		block_on(async { Ok(self.inner.read().await.len()) }, None).unwrap()
 	}
 }
 
@@ -0,0 +1,232 @@
+//! Lock-free per-core tracing and counting instrumentation.
+//!
+//! With the `trace` feature enabled, probes in hot kernel paths record
+//! typed tracepoints into a ring buffer of their core and bump a per-core
+//! counter per event kind. Recording is wait-free: the producing core
+//! claims a slot with a relaxed fetch-add and marks it valid by storing
+//! the slot's sequence number with release ordering, so probes never take
+//! a lock and readers discard slots they catch mid-update. Without the
+//! feature, every probe compiles to nothing.
+//!
+//! The recorded events can be retrieved at runtime via `sys_trace_read`
+//! and `sys_trace_counters` or, interactively, with the `trace` command of
+//! the kernel shell.
+
+#[cfg(feature = "trace")]
+use core::cell::UnsafeCell;
+#[cfg(feature = "trace")]
+use core::sync::atomic::{AtomicU64, Ordering};
+
+/// The kinds of events recorded by the kernel's tracepoints.
+#[derive(Debug, Copy, Clone)]
+#[repr(u32)]
+pub enum TracepointKind {
+	/// A context switch. The arguments are the IDs of the previous and the
+	/// next task.
+	ContextSwitch = 0,
+	/// A virtqueue dispatch. The arguments are the queue index and the
+	/// number of published transfers.
+	VirtqueueDispatch = 1,
+	/// A page fault. The arguments are the faulting address and the error
+	/// code.
+	PageFault = 2,
+	/// A futex wait. The argument is the futex address.
+	FutexWait = 3,
+	/// A futex wake. The arguments are the futex address and the number of
+	/// woken threads.
+	FutexWake = 4,
+}
+
+/// The number of [`TracepointKind`] variants.
+pub const TRACEPOINT_KIND_COUNT: usize = 5;
+
+/// The names of the [`TracepointKind`] variants, by their discriminant.
+#[allow(dead_code)]
+pub(crate) const TRACEPOINT_KIND_NAMES: [&str; TRACEPOINT_KIND_COUNT] = [
+	"context_switch",
+	"virtqueue_dispatch",
+	"page_fault",
+	"futex_wait",
+	"futex_wake",
+];
+
+/// One recorded tracepoint.
+#[allow(non_camel_case_types)]
+#[derive(Debug, Copy, Clone)]
+#[repr(C)]
+pub struct trace_entry {
+	/// Raw timestamp-counter value at the time of recording.
+	pub timestamp: u64,
+	/// The [`TracepointKind`] discriminant of the event.
+	pub kind: u32,
+	/// ID of the core that recorded the event.
+	pub core_id: u32,
+	/// First event argument; see [`TracepointKind`].
+	pub arg0: u64,
+	/// Second event argument; see [`TracepointKind`].
+	pub arg1: u64,
+}
+
+/// Entries of the ring buffer of each core.
+#[cfg(feature = "trace")]
+const RING_SIZE: usize = 512;
+
+/// The number of cores with their own ring buffer and counters. Probes on
+/// further cores only bump the counters of a shared buffer.
+#[cfg(feature = "trace")]
+const MAX_TRACED_CORES: usize = 64;
+
+#[cfg(feature = "trace")]
+struct CoreBuffer {
+	/// The next slot to claim; also the number of tracepoints ever
+	/// recorded on this core.
+	head: AtomicU64,
+	/// Sequence number (claimed index + 1) of every slot; zero while the
+	/// slot is empty or being overwritten.
+	seq: [AtomicU64; RING_SIZE],
+	entries: [UnsafeCell<trace_entry>; RING_SIZE],
+	/// Number of recorded events per [`TracepointKind`].
+	counters: [AtomicU64; TRACEPOINT_KIND_COUNT],
+}
+
+// The entries are only written by the owning core and readers validate
+// them against the slot's sequence number.
+#[cfg(feature = "trace")]
+unsafe impl Sync for CoreBuffer {}
+
+#[cfg(feature = "trace")]
+impl CoreBuffer {
+	const fn new() -> Self {
+		const EMPTY_ENTRY: trace_entry = trace_entry {
+			timestamp: 0,
+			kind: 0,
+			core_id: 0,
+			arg0: 0,
+			arg1: 0,
+		};
+
+		Self {
+			head: AtomicU64::new(0),
+			seq: [const { AtomicU64::new(0) }; RING_SIZE],
+			entries: [const { UnsafeCell::new(EMPTY_ENTRY) }; RING_SIZE],
+			counters: [const { AtomicU64::new(0) }; TRACEPOINT_KIND_COUNT],
+		}
+	}
+}
+
+#[cfg(feature = "trace")]
+static BUFFERS: [CoreBuffer; MAX_TRACED_CORES] = [const { CoreBuffer::new() }; MAX_TRACED_CORES];
+
+/// Records a tracepoint on the current core.
+#[cfg(feature = "trace")]
+pub(crate) fn tracepoint(kind: TracepointKind, arg0: u64, arg1: u64) {
+	let core_id = crate::arch::core_local::core_id() as usize;
+	let buffer = &BUFFERS[core_id % MAX_TRACED_CORES];
+
+	buffer.counters[kind as usize].fetch_add(1, Ordering::Relaxed);
+
+	// The ring entries of a buffer may only be written by its owning core
+	// (see the `Sync` impl of `CoreBuffer`), so further cores contribute
+	// to the shared buffer's counters only.
+	if core_id >= MAX_TRACED_CORES {
+		return;
+	}
+
+	let index = buffer.head.fetch_add(1, Ordering::Relaxed);
+	let slot = index as usize % RING_SIZE;
+	// Invalidate the slot, so that readers do not mistake the mixture of
+	// old and new fields for a valid entry.
+	buffer.seq[slot].store(0, Ordering::Release);
+	unsafe {
+		buffer.entries[slot].get().write(trace_entry {
+			timestamp: crate::arch::processor::get_timestamp(),
+			kind: kind as u32,
+			core_id: core_id as u32,
+			arg0,
+			arg1,
+		});
+	}
+	buffer.seq[slot].store(index + 1, Ordering::Release);
+}
+
+/// Records a tracepoint on the current core.
+#[cfg(not(feature = "trace"))]
+#[inline(always)]
+pub(crate) fn tracepoint(_kind: TracepointKind, _arg0: u64, _arg1: u64) {}
+
+/// Copies the most recent tracepoints of the given core into `buf`,
+/// oldest first, and returns how many were copied. Reading is a snapshot
+/// and does not consume the entries. Returns `None` for an invalid core.
+#[cfg(feature = "trace")]
+pub(crate) fn read(core_id: usize, buf: &mut [trace_entry]) -> Option<usize> {
+	let buffer = BUFFERS.get(core_id)?;
+
+	let head = buffer.head.load(Ordering::Acquire);
+	let available = head.min(RING_SIZE as u64);
+	let mut copied = 0;
+	for index in (head - available)..head {
+		if copied == buf.len() {
+			break;
+		}
+
+		let slot = index as usize % RING_SIZE;
+		let seq = buffer.seq[slot].load(Ordering::Acquire);
+		if seq != index + 1 {
+			// The slot is being overwritten right now.
+			continue;
+		}
+		let entry = unsafe { buffer.entries[slot].get().read() };
+		if buffer.seq[slot].load(Ordering::Acquire) != seq {
+			continue;
+		}
+
+		buf[copied] = entry;
+		copied += 1;
+	}
+
+	Some(copied)
+}
+
+#[cfg(not(feature = "trace"))]
+pub(crate) fn read(_core_id: usize, _buf: &mut [trace_entry]) -> Option<usize> {
+	None
+}
+
+/// Returns the tracepoint counters of the given core, indexed by
+/// [`TracepointKind`] discriminant, or `None` for an invalid core.
+#[cfg(feature = "trace")]
+pub(crate) fn counters(core_id: usize) -> Option<[u64; TRACEPOINT_KIND_COUNT]> {
+	let buffer = BUFFERS.get(core_id)?;
+
+	let mut counters = [0; TRACEPOINT_KIND_COUNT];
+	for (counter, value) in buffer.counters.iter().zip(counters.iter_mut()) {
+		*value = counter.load(Ordering::Relaxed);
+	}
+
+	Some(counters)
+}
+
+#[cfg(not(feature = "trace"))]
+pub(crate) fn counters(_core_id: usize) -> Option<[u64; TRACEPOINT_KIND_COUNT]> {
+	None
+}
+
+/// Prints the tracepoint counters of all cores that have recorded events.
+#[allow(dead_code)]
+pub(crate) fn print_statistics() {
+	#[cfg(feature = "trace")]
+	for core_id in 0..MAX_TRACED_CORES {
+		let counters = counters(core_id).unwrap();
+		if counters.iter().all(|&count| count == 0) {
+			continue;
+		}
+
+		info!("Tracepoints of core {}:", core_id);
+		for (name, count) in TRACEPOINT_KIND_NAMES.iter().zip(counters) {
+			info!("[{core_id}][{name}]: {count}");
+		}
+	}
+
+	#[cfg(not(feature = "trace"))]
+	info!("Tracing is disabled. Rebuild with the `trace` feature to enable it.");
+}
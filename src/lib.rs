@@ -85,6 +85,7 @@ pub mod errno;
 mod executor;
 pub mod fd;
 pub mod fs;
+pub(crate) mod instrumentation;
 pub mod io;
 mod mm;
 pub mod scheduler;
@@ -218,6 +219,10 @@ fn boot_processor_main() -> ! {
 	#[cfg(feature = "smp")]
 	synch_all_cores();
 
+	// All cores are online and can be identified, so the heap allocator
+	// can start serving small allocations from per-core caches.
+	mm::allocator::init_per_core_caches(arch::get_processor_count() as usize);
+
 	#[cfg(feature = "pci")]
 	info!("Compiled with PCI support");
 	#[cfg(feature = "acpi")]
@@ -266,6 +271,9 @@ fn application_processor_main() -> ! {
 #[cfg(target_os = "none")]
 #[panic_handler]
 fn panic(info: &core::panic::PanicInfo<'_>) -> ! {
+	// The console drain task does not run anymore.
+	crate::console::disable_buffering();
+
 	let core_id = crate::arch::core_local::core_id();
 	println!("[{core_id}][PANIC] {info}");
 
@@ -1,11 +1,76 @@
 //! Implementation of the Hermit Allocator for dynamically allocating heap memory
 //! in the kernel.
 
+use alloc::boxed::Box;
+use alloc::vec::Vec;
 use core::alloc::{GlobalAlloc, Layout};
+use core::{mem, ptr};
 
-use hermit_sync::RawInterruptTicketMutex;
+use crossbeam_utils::CachePadded;
+use hermit_sync::{InterruptTicketMutex, OnceCell, RawInterruptTicketMutex};
 use talc::{ErrOnOom, Span, Talc, Talck};
 
+use crate::arch::core_local::core_id;
+
+/// Minimum alignment (and smallest size class) of every heap allocation.
+/// All requests are padded to a cache line to avoid false sharing.
+const MIN_SIZE: usize = mem::align_of::<CachePadded<u8>>();
+/// Number of size classes served by the per-core caches.
+/// Class `i` holds blocks of `MIN_SIZE << i` bytes.
+const SIZE_CLASSES: usize = 3;
+/// Largest allocation size served by the per-core caches.
+const MAX_CACHED_SIZE: usize = MIN_SIZE << (SIZE_CLASSES - 1);
+/// Number of blocks a magazine can hold per size class.
+const MAGAZINE_SIZE: usize = 32;
+/// Number of blocks fetched from the global arena on a magazine miss.
+const REFILL_COUNT: usize = MAGAZINE_SIZE / 2;
+
+/// A per-core stack of free blocks for every size class.
+///
+/// Only the owning core pushes and pops blocks, so the protecting mutex
+/// is never contended; it merely guards against interrupt handlers that
+/// allocate on the same core.
+struct Magazines {
+	blocks: [[*mut u8; MAGAZINE_SIZE]; SIZE_CLASSES],
+	len: [usize; SIZE_CLASSES],
+}
+
+// SAFETY: The raw pointers refer to free heap blocks, which are not
+// accessed until they are handed out again by `alloc`.
+unsafe impl Send for Magazines {}
+
+impl Magazines {
+	const fn new() -> Self {
+		Self {
+			blocks: [[ptr::null_mut(); MAGAZINE_SIZE]; SIZE_CLASSES],
+			len: [0; SIZE_CLASSES],
+		}
+	}
+}
+
+/// Per-core frontends, indexed by core ID.
+/// Initialized by [`init_per_core_caches`] once all cores are online.
+static CORE_CACHES: OnceCell<&'static [CachePadded<InterruptTicketMutex<Magazines>>]> =
+	OnceCell::new();
+
+/// Returns the size class of `layout` or `None` if the allocation
+/// has to be served by the global arena.
+#[inline]
+fn size_class(layout: Layout) -> Option<usize> {
+	if layout.align() <= MIN_SIZE && layout.size() <= MAX_CACHED_SIZE {
+		let class = (layout.size().max(MIN_SIZE).next_power_of_two() / MIN_SIZE).ilog2();
+		Some(class as usize)
+	} else {
+		None
+	}
+}
+
+/// Returns the canonical layout of all blocks in `class`.
+#[inline]
+fn class_layout(class: usize) -> Layout {
+	Layout::from_size_align(MIN_SIZE << class, MIN_SIZE).unwrap()
+}
+
 pub struct LockedAllocator(Talck<RawInterruptTicketMutex, ErrOnOom>);
 
 impl LockedAllocator {
@@ -15,9 +80,7 @@ impl LockedAllocator {
 
 	#[inline]
 	fn align_layout(layout: Layout) -> Layout {
-		let align = layout
-			.align()
-			.max(core::mem::align_of::<crossbeam_utils::CachePadded<u8>>());
+		let align = layout.align().max(MIN_SIZE);
 		Layout::from_size_align(layout.size(), align).unwrap()
 	}
 
@@ -27,6 +90,78 @@ impl LockedAllocator {
 			self.0.lock().claim(arena).unwrap();
 		}
 	}
+
+	/// Allocates a block of `class` directly from the global arena.
+	#[inline]
+	unsafe fn alloc_from_arena(&self, class: usize) -> *mut u8 {
+		unsafe { self.0.alloc(class_layout(class)) }
+	}
+
+	/// Allocates a small block, preferably from the local magazine.
+	unsafe fn alloc_small(&self, class: usize) -> *mut u8 {
+		if let Some(caches) = CORE_CACHES.get() {
+			if let Some(cache) = caches.get(core_id() as usize) {
+				let mut mags = cache.lock();
+				if let Some(new_len) = mags.len[class].checked_sub(1) {
+					mags.len[class] = new_len;
+					return mags.blocks[class][new_len];
+				}
+
+				// Magazine is empty. Refill it from the global arena and
+				// keep the last block for the current request.
+				for _ in 0..REFILL_COUNT - 1 {
+					let block = unsafe { self.alloc_from_arena(class) };
+					if block.is_null() {
+						break;
+					}
+					let len = mags.len[class];
+					mags.blocks[class][len] = block;
+					mags.len[class] = len + 1;
+				}
+			}
+		}
+
+		unsafe { self.alloc_from_arena(class) }
+	}
+
+	/// Frees a small block into the local magazine, flushing
+	/// excess blocks back to the global arena.
+	unsafe fn dealloc_small(&self, ptr: *mut u8, class: usize) {
+		if let Some(caches) = CORE_CACHES.get() {
+			if let Some(cache) = caches.get(core_id() as usize) {
+				let mut mags = cache.lock();
+				if mags.len[class] == MAGAZINE_SIZE {
+					// Magazine is full. Return half of it to the global arena.
+					for _ in 0..MAGAZINE_SIZE / 2 {
+						let len = mags.len[class] - 1;
+						mags.len[class] = len;
+						unsafe {
+							self.0.dealloc(mags.blocks[class][len], class_layout(class));
+						}
+					}
+				}
+
+				let len = mags.len[class];
+				mags.blocks[class][len] = ptr;
+				mags.len[class] = len + 1;
+				return;
+			}
+		}
+
+		unsafe { self.0.dealloc(ptr, class_layout(class)) }
+	}
+}
+
+/// Enables the per-core allocator frontends.
+///
+/// Has to be called after all cores are online, since the frontends
+/// determine the local magazine via [`core_id`].
+pub(crate) fn init_per_core_caches(cores: usize) {
+	let mut caches = Vec::with_capacity(cores);
+	caches.resize_with(cores, || {
+		CachePadded::new(InterruptTicketMutex::new(Magazines::new()))
+	});
+	CORE_CACHES.set(Box::leak(caches.into_boxed_slice())).ok();
 }
 
 /// To avoid false sharing, the global memory allocator align
@@ -34,22 +169,59 @@ impl LockedAllocator {
 unsafe impl GlobalAlloc for LockedAllocator {
 	unsafe fn alloc(&self, layout: Layout) -> *mut u8 {
 		let layout = Self::align_layout(layout);
-		unsafe { self.0.alloc(layout) }
+		match size_class(layout) {
+			Some(class) => unsafe { self.alloc_small(class) },
+			None => unsafe { self.0.alloc(layout) },
+		}
 	}
 
 	unsafe fn dealloc(&self, ptr: *mut u8, layout: Layout) {
 		let layout = Self::align_layout(layout);
-		unsafe { self.0.dealloc(ptr, layout) }
+		match size_class(layout) {
+			Some(class) => unsafe { self.dealloc_small(ptr, class) },
+			None => unsafe { self.0.dealloc(ptr, layout) },
+		}
 	}
 
 	unsafe fn alloc_zeroed(&self, layout: Layout) -> *mut u8 {
 		let layout = Self::align_layout(layout);
-		unsafe { self.0.alloc_zeroed(layout) }
+		match size_class(layout) {
+			Some(class) => {
+				let ptr = unsafe { self.alloc_small(class) };
+				if !ptr.is_null() {
+					unsafe {
+						ptr.write_bytes(0, layout.size());
+					}
+				}
+				ptr
+			}
+			None => unsafe { self.0.alloc_zeroed(layout) },
+		}
 	}
 
 	unsafe fn realloc(&self, ptr: *mut u8, layout: Layout, new_size: usize) -> *mut u8 {
-		let layout = Self::align_layout(layout);
-		unsafe { self.0.realloc(ptr, layout, new_size) }
+		let old_layout = Self::align_layout(layout);
+		let new_layout =
+			Self::align_layout(Layout::from_size_align(new_size, layout.align()).unwrap());
+
+		match (size_class(old_layout), size_class(new_layout)) {
+			(None, None) => unsafe { self.0.realloc(ptr, old_layout, new_size) },
+			(old_class, new_class) => {
+				if old_class.is_some() && old_class == new_class {
+					// The new size still fits into the block's size class.
+					return ptr;
+				}
+
+				let new_ptr = unsafe { self.alloc(new_layout) };
+				if !new_ptr.is_null() {
+					unsafe {
+						ptr::copy_nonoverlapping(ptr, new_ptr, layout.size().min(new_size));
+						self.dealloc(ptr, layout);
+					}
+				}
+				new_ptr
+			}
+		}
 	}
 }
 
@@ -76,4 +248,29 @@ mod tests {
 		let addr = unsafe { allocator.alloc(layout) };
 		assert!(addr.is_null());
 	}
+
+	#[test]
+	fn small_classes() {
+		assert_eq!(size_class(Layout::from_size_align(1, 1).unwrap()), Some(0));
+		assert_eq!(
+			size_class(Layout::from_size_align(MIN_SIZE, MIN_SIZE).unwrap()),
+			Some(0)
+		);
+		assert_eq!(
+			size_class(Layout::from_size_align(MIN_SIZE + 1, MIN_SIZE).unwrap()),
+			Some(1)
+		);
+		assert_eq!(
+			size_class(Layout::from_size_align(MAX_CACHED_SIZE, MIN_SIZE).unwrap()),
+			Some(SIZE_CLASSES - 1)
+		);
+		assert_eq!(
+			size_class(Layout::from_size_align(MAX_CACHED_SIZE + 1, MIN_SIZE).unwrap()),
+			None
+		);
+		assert_eq!(
+			size_class(Layout::from_size_align(1, 2 * MIN_SIZE).unwrap()),
+			None
+		);
+	}
 }
@@ -0,0 +1,299 @@
+//! Demand paging for memory-mapped regions.
+//!
+//! `sys_mmap` only reserves virtual address space and registers the region
+//! here; physical frames are allocated, zeroed, and mapped on first access
+//! by the page-fault handler. Read faults map a shared zero page, which is
+//! replaced by a private zeroed frame on the first write.
+
+use alloc::collections::BTreeMap;
+use core::ptr;
+
+use hermit_sync::{InterruptSpinMutex, OnceCell};
+
+use crate::arch;
+use crate::arch::mm::paging::{
+	BasePageSize, LargePageSize, PageSize, PageTableEntryFlags, PageTableEntryFlagsExt,
+	TlbFlushBatch,
+};
+use crate::arch::mm::{PhysAddr, VirtAddr};
+
+/// A demand-paged virtual memory region.
+struct Region {
+	/// First address past the region.
+	end: usize,
+	/// Flags for the page table entries of faulted-in pages.
+	flags: PageTableEntryFlags,
+}
+
+/// Demand-paged regions, keyed by their start address.
+///
+/// The lock also serializes concurrent page faults, so two cores faulting on
+/// the same page cannot both map a fresh frame.
+static REGIONS: InterruptSpinMutex<BTreeMap<usize, Region>> =
+	InterruptSpinMutex::new(BTreeMap::new());
+
+/// The frame of the shared zero page, which read faults map read-only.
+static ZERO_PAGE: OnceCell<PhysAddr> = OnceCell::new();
+
+fn zero_page() -> PhysAddr {
+	*ZERO_PAGE.get_or_init(|| {
+		let frame = arch::mm::physicalmem::allocate(BasePageSize::SIZE as usize).unwrap();
+
+		// Zero the frame through a scratch mapping.
+		let page = arch::mm::virtualmem::allocate(BasePageSize::SIZE as usize).unwrap();
+		let mut flags = PageTableEntryFlags::empty();
+		flags.normal().writable().execute_disable();
+		arch::mm::paging::map::<BasePageSize>(page, frame, 1, flags);
+		unsafe {
+			ptr::write_bytes(page.as_mut_ptr::<u8>(), 0, BasePageSize::SIZE as usize);
+		}
+		arch::mm::paging::unmap::<BasePageSize>(page, 1);
+		arch::mm::virtualmem::deallocate(page, BasePageSize::SIZE as usize);
+
+		frame
+	})
+}
+
+/// Returns `true` if the frame is the shared zero page.
+pub(crate) fn is_zero_page(frame: PhysAddr) -> bool {
+	ZERO_PAGE.get().copied() == Some(frame)
+}
+
+/// Removes all region coverage of `[start, end)`, truncating and splitting
+/// overlapping regions as necessary.
+fn carve(regions: &mut BTreeMap<usize, Region>, start: usize, end: usize) {
+	// Truncate a region that begins before the carved range.
+	if let Some((_, region)) = regions.range_mut(..start).next_back() {
+		if region.end > start {
+			let region_end = region.end;
+			let flags = region.flags;
+			region.end = start;
+			if region_end > end {
+				regions.insert(
+					end,
+					Region {
+						end: region_end,
+						flags,
+					},
+				);
+			}
+		}
+	}
+
+	// Remove regions that begin inside the carved range.
+	while let Some(region_start) = regions.range(start..end).next().map(|(&start, _)| start) {
+		let region = regions.remove(&region_start).unwrap();
+		if region.end > end {
+			regions.insert(
+				end,
+				Region {
+					end: region.end,
+					flags: region.flags,
+				},
+			);
+		}
+	}
+}
+
+/// Registers `[addr, addr + size)` as demand-paged with the given page table
+/// entry flags, replacing any previous registration of the range.
+pub(crate) fn register(addr: VirtAddr, size: usize, flags: PageTableEntryFlags) {
+	let start = addr.as_usize();
+	let end = start + size;
+
+	let mut regions = REGIONS.lock();
+	carve(&mut regions, start, end);
+	regions.insert(start, Region { end, flags });
+}
+
+/// Unregisters all demand-paged regions within `[addr, addr + size)`.
+pub(crate) fn unregister(addr: VirtAddr, size: usize) {
+	let start = addr.as_usize();
+
+	let mut regions = REGIONS.lock();
+	carve(&mut regions, start, start + size);
+}
+
+/// Tries to resolve a page fault at `addr` by mapping a frame on demand.
+///
+/// Returns `true` if the fault was resolved and the faulting instruction can
+/// be retried.
+pub(crate) fn page_fault(addr: VirtAddr, write: bool, instruction_fetch: bool) -> bool {
+	let regions = REGIONS.lock();
+
+	let Some((&start, region)) = regions.range(..=addr.as_usize()).next_back() else {
+		return false;
+	};
+	if addr.as_usize() >= region.end {
+		return false;
+	}
+
+	let flags = region.flags;
+	if write && !flags.contains(PageTableEntryFlags::WRITABLE) {
+		return false;
+	}
+	if instruction_fetch && flags.contains(PageTableEntryFlags::NO_EXECUTE) {
+		return false;
+	}
+
+	let page = addr.align_down(BasePageSize::SIZE);
+
+	if let Some(frame) = arch::mm::paging::virtual_to_physical(page) {
+		if !(write && is_zero_page(frame)) {
+			// Another core already resolved this fault.
+			return true;
+		}
+	}
+
+	if write {
+		// Back eligible parts of large regions with large pages.
+		if map_large(addr, start, region.end, flags) {
+			return true;
+		}
+
+		// Map a private frame and zero it through the new mapping. This also
+		// replaces a read-only mapping of the shared zero page.
+		let Ok(frame) = arch::mm::physicalmem::allocate(BasePageSize::SIZE as usize) else {
+			return false;
+		};
+		arch::mm::paging::map::<BasePageSize>(page, frame, 1, flags);
+		unsafe {
+			ptr::write_bytes(page.as_mut_ptr::<u8>(), 0, BasePageSize::SIZE as usize);
+		}
+	} else {
+		// Map the shared zero page read-only. The first write replaces it
+		// with a private frame.
+		let mut flags = flags;
+		flags.remove(PageTableEntryFlags::WRITABLE);
+		arch::mm::paging::map::<BasePageSize>(page, zero_page(), 1, flags);
+	}
+
+	true
+}
+
+/// Tries to resolve a write fault at `addr` with a large page to relieve TLB
+/// pressure.
+///
+/// This requires the large page around `addr` to lie entirely within the
+/// region `[start, end)` and a contiguous aligned physical allocation;
+/// otherwise the fault falls back to base pages.
+fn map_large(addr: VirtAddr, start: usize, end: usize, flags: PageTableEntryFlags) -> bool {
+	if !arch::processor::supports_2mib_pages() {
+		return false;
+	}
+
+	let page = addr.align_down(LargePageSize::SIZE);
+	if page.as_usize() < start || page.as_usize() + LargePageSize::SIZE as usize > end {
+		return false;
+	}
+
+	// The only frames that may already be mapped inside the large page are
+	// read-faulted zero pages, which the fresh zeroed frame replaces without
+	// losing data.
+	let base_pages = (0..(LargePageSize::SIZE / BasePageSize::SIZE) as usize)
+		.map(|n| page + n * BasePageSize::SIZE as usize);
+	for base_page in base_pages.clone() {
+		if let Some(frame) = arch::mm::paging::virtual_to_physical(base_page) {
+			if !is_zero_page(frame) {
+				return false;
+			}
+		}
+	}
+
+	let Ok(frame) = arch::mm::physicalmem::allocate_aligned(
+		LargePageSize::SIZE as usize,
+		LargePageSize::SIZE as usize,
+	) else {
+		return false;
+	};
+
+	// Unmap leftover zero page mappings and free the emptied page table, so
+	// that the large mapping does not collide with it. The invalidations are
+	// flushed on all cores before the private frame replaces the zero page.
+	let mut batch = TlbFlushBatch::new();
+	for base_page in base_pages {
+		if arch::mm::paging::virtual_to_physical(base_page).is_some() {
+			arch::mm::paging::unmap_batched::<BasePageSize>(base_page, 1, &mut batch);
+		}
+	}
+	batch.flush();
+	arch::mm::paging::clean_up_range(page, LargePageSize::SIZE as usize);
+
+	arch::mm::paging::map::<LargePageSize>(page, frame, 1, flags);
+	unsafe {
+		ptr::write_bytes(page.as_mut_ptr::<u8>(), 0, LargePageSize::SIZE as usize);
+	}
+
+	true
+}
+
+/// Unmaps all populated pages in `[addr, addr + size)` and deallocates their
+/// frames.
+///
+/// Demand-paged mappings are sparse, backed by a mix of base and large pages,
+/// and share the zero page, so every mapping has to be inspected separately.
+/// A large page that is only partially covered by the range is unmapped as a
+/// whole.
+pub(crate) fn unmap_pages(addr: VirtAddr, size: usize) {
+	// Queue all TLB invalidations and flush them in one batch with a single
+	// shootdown at the end.
+	let mut batch = TlbFlushBatch::new();
+
+	let end = addr + size;
+
+	let mut page = addr;
+	while page < end {
+		let Some((frame, page_size)) = arch::mm::paging::translate_mapping(page) else {
+			page += BasePageSize::SIZE as usize;
+			continue;
+		};
+
+		if page_size == LargePageSize::SIZE {
+			let large_page = page.align_down(LargePageSize::SIZE);
+			arch::mm::paging::unmap_batched::<LargePageSize>(large_page, 1, &mut batch);
+			arch::mm::physicalmem::deallocate(frame, page_size as usize);
+			page = large_page + LargePageSize::SIZE as usize;
+		} else {
+			arch::mm::paging::unmap_batched::<BasePageSize>(page, 1, &mut batch);
+			// The shared zero page is mapped into all demand-paged regions.
+			if !is_zero_page(frame) {
+				arch::mm::physicalmem::deallocate(frame, page_size as usize);
+			}
+			page += BasePageSize::SIZE as usize;
+		}
+	}
+
+	batch.flush();
+}
+
+/// Applies new page table entry flags to all populated pages in
+/// `[addr, addr + size)`.
+///
+/// Mappings of the shared zero page are unmapped instead, since the zero page
+/// must never become writable; the next access faults the page in again with
+/// the new flags. A large page that is only partially covered by the range is
+/// remapped as a whole.
+pub(crate) fn protect_pages(addr: VirtAddr, size: usize, flags: PageTableEntryFlags) {
+	let end = addr + size;
+
+	let mut page = addr;
+	while page < end {
+		let Some((frame, page_size)) = arch::mm::paging::translate_mapping(page) else {
+			page += BasePageSize::SIZE as usize;
+			continue;
+		};
+
+		if page_size == LargePageSize::SIZE {
+			let large_page = page.align_down(LargePageSize::SIZE);
+			arch::mm::paging::map::<LargePageSize>(large_page, frame, 1, flags);
+			page = large_page + LargePageSize::SIZE as usize;
+		} else {
+			if is_zero_page(frame) {
+				arch::mm::paging::unmap::<BasePageSize>(page, 1);
+			} else {
+				arch::mm::paging::map::<BasePageSize>(page, frame, 1, flags);
+			}
+			page += BasePageSize::SIZE as usize;
+		}
+	}
+}
@@ -1,13 +1,16 @@
 pub mod allocator;
+#[cfg(all(target_arch = "x86_64", not(feature = "common-os")))]
+pub(crate) mod demand_paging;
 pub mod device_alloc;
 
+use alloc::collections::BTreeMap;
 use core::mem;
 use core::ops::Range;
 
 use align_address::Align;
-use hermit_sync::Lazy;
 #[cfg(feature = "newlib")]
 use hermit_sync::OnceCell;
+use hermit_sync::{InterruptSpinMutex, Lazy};
 
 use self::allocator::LockedAllocator;
 #[cfg(any(target_arch = "x86_64", target_arch = "riscv64"))]
@@ -312,18 +315,71 @@ pub(crate) fn print_information() {
 	arch::mm::virtualmem::print_information();
 }
 
+/// Allocations of [`allocate`] that are backed by large or huge pages, keyed
+/// by their virtual start address and mapped to the size of the backing pages.
+///
+/// [`deallocate`] has to unmap such allocations with the page size they were
+/// mapped with.
+static LARGE_ALLOCATIONS: InterruptSpinMutex<BTreeMap<usize, usize>> =
+	InterruptSpinMutex::new(BTreeMap::new());
+
 /// Soft-deprecated in favor of `DeviceAlloc`
 pub(crate) fn allocate(size: usize, no_execution: bool) -> VirtAddr {
 	let size = size.align_up(BasePageSize::SIZE as usize);
-	let physical_address = arch::mm::physicalmem::allocate(size).unwrap();
-	let virtual_address = arch::mm::virtualmem::allocate(size).unwrap();
 
-	let count = size / BasePageSize::SIZE as usize;
 	let mut flags = PageTableEntryFlags::empty();
 	flags.normal().writable();
 	if no_execution {
 		flags.execute_disable();
 	}
+
+	// Back large allocations with larger pages to relieve TLB pressure. Both
+	// address ranges have to be aligned to the page size, so this is only done
+	// for multiples of it; if the physical memory is too fragmented for a
+	// contiguous aligned allocation, fall through to the next page size.
+	#[cfg(any(target_arch = "x86_64", target_arch = "riscv64"))]
+	if size % HugePageSize::SIZE as usize == 0 && arch::processor::supports_1gib_pages() {
+		if let Ok(physical_address) =
+			arch::mm::physicalmem::allocate_aligned(size, HugePageSize::SIZE as usize)
+		{
+			let virtual_address =
+				arch::mm::virtualmem::allocate_aligned(size, HugePageSize::SIZE as usize).unwrap();
+			arch::mm::paging::map::<HugePageSize>(
+				virtual_address,
+				physical_address,
+				size / HugePageSize::SIZE as usize,
+				flags,
+			);
+			LARGE_ALLOCATIONS
+				.lock()
+				.insert(virtual_address.as_usize(), HugePageSize::SIZE as usize);
+			return virtual_address;
+		}
+	}
+
+	if size % LargePageSize::SIZE as usize == 0 && arch::processor::supports_2mib_pages() {
+		if let Ok(physical_address) =
+			arch::mm::physicalmem::allocate_aligned(size, LargePageSize::SIZE as usize)
+		{
+			let virtual_address =
+				arch::mm::virtualmem::allocate_aligned(size, LargePageSize::SIZE as usize).unwrap();
+			arch::mm::paging::map::<LargePageSize>(
+				virtual_address,
+				physical_address,
+				size / LargePageSize::SIZE as usize,
+				flags,
+			);
+			LARGE_ALLOCATIONS
+				.lock()
+				.insert(virtual_address.as_usize(), LargePageSize::SIZE as usize);
+			return virtual_address;
+		}
+	}
+
+	let physical_address = arch::mm::physicalmem::allocate(size).unwrap();
+	let virtual_address = arch::mm::virtualmem::allocate(size).unwrap();
+
+	let count = size / BasePageSize::SIZE as usize;
 	arch::mm::paging::map::<BasePageSize>(virtual_address, physical_address, count, flags);
 
 	virtual_address
@@ -333,6 +389,24 @@ pub(crate) fn allocate(size: usize, no_execution: bool) -> VirtAddr {
 pub(crate) fn deallocate(virtual_address: VirtAddr, size: usize) {
 	let size = size.align_up(BasePageSize::SIZE as usize);
 
+	let page_size = LARGE_ALLOCATIONS.lock().remove(&virtual_address.as_usize());
+	if let Some(page_size) = page_size {
+		let phys_addr = arch::mm::paging::virtual_to_physical(virtual_address).unwrap();
+		match page_size {
+			#[cfg(any(target_arch = "x86_64", target_arch = "riscv64"))]
+			_ if page_size == HugePageSize::SIZE as usize => {
+				arch::mm::paging::unmap::<HugePageSize>(virtual_address, size / page_size);
+			}
+			_ if page_size == LargePageSize::SIZE as usize => {
+				arch::mm::paging::unmap::<LargePageSize>(virtual_address, size / page_size);
+			}
+			_ => unreachable!(),
+		}
+		arch::mm::virtualmem::deallocate(virtual_address, size);
+		arch::mm::physicalmem::deallocate(phys_addr, size);
+		return;
+	}
+
 	if let Some(phys_addr) = arch::mm::paging::virtual_to_physical(virtual_address) {
 		arch::mm::paging::unmap::<BasePageSize>(
 			virtual_address,
@@ -4,20 +4,14 @@ use alloc::boxed::Box;
 use alloc::collections::{BTreeMap, VecDeque};
 use alloc::rc::Rc;
 use alloc::sync::Arc;
-#[cfg(feature = "smp")]
 use alloc::vec::Vec;
 use core::cell::RefCell;
-use core::future::{self, Future};
 use core::ptr;
 #[cfg(all(target_arch = "x86_64", feature = "smp"))]
 use core::sync::atomic::AtomicBool;
 use core::sync::atomic::{AtomicI32, AtomicU32, Ordering};
-use core::task::ready;
-use core::task::Poll::Ready;
 
-use ahash::RandomState;
 use crossbeam_utils::Backoff;
-use hashbrown::HashMap;
 use hermit_sync::*;
 #[cfg(target_arch = "riscv64")]
 use riscv::register::sstatus;
@@ -29,7 +23,9 @@ use crate::arch::switch::switch_to_task;
 #[cfg(target_arch = "x86_64")]
 use crate::arch::switch::{switch_to_fpu_owner, switch_to_task};
 use crate::arch::{get_processor_count, interrupts};
-use crate::fd::{FileDescriptor, IoError, ObjectInterface};
+#[cfg(all(any(target_arch = "x86_64", target_arch = "riscv64"), feature = "smp"))]
+use crate::executor::task::AsyncTask;
+use crate::fd::{IoError, ObjectMap};
 use crate::kernel::scheduler::TaskStacks;
 use crate::scheduler::task::*;
 
@@ -38,8 +34,7 @@ pub mod task;
 static NO_TASKS: AtomicU32 = AtomicU32::new(0);
 /// Map between Core ID and per-core scheduler
 #[cfg(feature = "smp")]
-static SCHEDULER_INPUTS: SpinMutex<Vec<&InterruptTicketMutex<SchedulerInput>>> =
-	SpinMutex::new(Vec::new());
+static SCHEDULER_INPUTS: SpinMutex<Vec<&SchedulerInput>> = SpinMutex::new(Vec::new());
 #[cfg(all(target_arch = "x86_64", feature = "smp"))]
 static CORE_HLT_STATE: SpinMutex<Vec<&AtomicBool>> = SpinMutex::new(Vec::new());
 /// Map between Task ID and Queue of waiting tasks
@@ -52,24 +47,66 @@ static TASKS: InterruptTicketMutex<BTreeMap<TaskId, TaskHandle>> =
 /// Unique identifier for a core.
 pub type CoreId = u32;
 
+/// Lock-free queues to pass tasks to another core.
+///
+/// Sending is lock-free, so a core waking a task on another core does not
+/// contend with the receiving core's scheduling hot path.
 #[cfg(feature = "smp")]
 pub(crate) struct SchedulerInput {
 	/// Queue of new tasks
-	new_tasks: VecDeque<NewTask>,
+	new_tasks_sender: async_channel::Sender<NewTask>,
+	new_tasks_receiver: async_channel::Receiver<NewTask>,
 	/// Queue of task, which are wakeup by another core
-	wakeup_tasks: VecDeque<TaskHandle>,
+	wakeup_tasks_sender: async_channel::Sender<TaskHandle>,
+	wakeup_tasks_receiver: async_channel::Receiver<TaskHandle>,
+	/// Queue of ready tasks, which are offloaded by another core
+	#[cfg(target_arch = "x86_64")]
+	migrated_tasks_sender: async_channel::Sender<MigratedTask>,
+	#[cfg(target_arch = "x86_64")]
+	migrated_tasks_receiver: async_channel::Receiver<MigratedTask>,
+	/// Queue of async tasks, which are spawned with affinity for this core
+	#[cfg(any(target_arch = "x86_64", target_arch = "riscv64"))]
+	async_tasks_sender: async_channel::Sender<AsyncTask>,
+	#[cfg(any(target_arch = "x86_64", target_arch = "riscv64"))]
+	async_tasks_receiver: async_channel::Receiver<AsyncTask>,
 }
 
 #[cfg(feature = "smp")]
 impl SchedulerInput {
 	pub fn new() -> Self {
+		let (new_tasks_sender, new_tasks_receiver) = async_channel::unbounded();
+		let (wakeup_tasks_sender, wakeup_tasks_receiver) = async_channel::unbounded();
+		#[cfg(target_arch = "x86_64")]
+		let (migrated_tasks_sender, migrated_tasks_receiver) = async_channel::unbounded();
+		#[cfg(any(target_arch = "x86_64", target_arch = "riscv64"))]
+		let (async_tasks_sender, async_tasks_receiver) = async_channel::unbounded();
 		Self {
-			new_tasks: VecDeque::new(),
-			wakeup_tasks: VecDeque::new(),
+			new_tasks_sender,
+			new_tasks_receiver,
+			wakeup_tasks_sender,
+			wakeup_tasks_receiver,
+			#[cfg(target_arch = "x86_64")]
+			migrated_tasks_sender,
+			#[cfg(target_arch = "x86_64")]
+			migrated_tasks_receiver,
+			#[cfg(any(target_arch = "x86_64", target_arch = "riscv64"))]
+			async_tasks_sender,
+			#[cfg(any(target_arch = "x86_64", target_arch = "riscv64"))]
+			async_tasks_receiver,
 		}
 	}
 }
 
+/// A ready task on its way to another core.
+#[cfg(all(target_arch = "x86_64", feature = "smp"))]
+struct MigratedTask(Task);
+
+// `Task` is not `Send` because of the raw thread pointer in `TaskTLS`. The
+// pointer targets the task's heap-allocated TLS block, which stays valid
+// when the task is moved to another core.
+#[cfg(all(target_arch = "x86_64", feature = "smp"))]
+unsafe impl Send for MigratedTask {}
+
 #[cfg_attr(any(target_arch = "x86_64", target_arch = "aarch64"), repr(align(128)))]
 #[cfg_attr(
 	not(any(target_arch = "x86_64", target_arch = "aarch64")),
@@ -92,8 +129,13 @@ pub(crate) struct PerCoreScheduler {
 	finished_tasks: VecDeque<Rc<RefCell<Task>>>,
 	/// Queue of blocked tasks, sorted by wakeup time.
 	blocked_tasks: BlockedTaskQueue,
+	/// Stacks of finished tasks, kept for reuse by new tasks
+	stack_pool: Vec<TaskStacks>,
 }
 
+/// Maximal number of retired task stacks kept for reuse per core.
+const STACK_POOL_SIZE: usize = 8;
+
 pub(crate) trait PerCoreSchedulerExt {
 	/// Triggers the scheduler to reschedule the tasks.
 	/// Interrupt flag will be cleared during the reschedule
@@ -212,8 +254,7 @@ struct NewTask {
 	prio: Priority,
 	core_id: CoreId,
 	stacks: TaskStacks,
-	object_map:
-		Arc<async_lock::RwLock<HashMap<FileDescriptor, Arc<dyn ObjectInterface>, RandomState>>>,
+	object_map: Arc<ObjectMap>,
 }
 
 impl From<NewTask> for Task {
@@ -244,7 +285,7 @@ impl PerCoreScheduler {
 	) -> TaskId {
 		// Create the new task.
 		let tid = get_tid();
-		let stacks = TaskStacks::new(stack_size);
+		let stacks = core_scheduler().get_task_stacks(stack_size);
 		let new_task = NewTask {
 			tid,
 			func,
@@ -257,8 +298,6 @@ impl PerCoreScheduler {
 
 		// Add it to the task lists.
 		let wakeup = {
-			#[cfg(feature = "smp")]
-			let mut input_locked = get_scheduler_input(core_id).lock();
 			WAITING_TASKS.lock().insert(tid, VecDeque::with_capacity(1));
 			TASKS.lock().insert(
 				tid,
@@ -273,7 +312,10 @@ impl PerCoreScheduler {
 
 			#[cfg(feature = "smp")]
 			if core_id != core_scheduler().core_id {
-				input_locked.new_tasks.push_back(new_task);
+				get_scheduler_input(core_id)
+					.new_tasks_sender
+					.try_send(new_task)
+					.unwrap();
 				true
 			} else {
 				let task = Rc::new(RefCell::new(Task::from(new_task)));
@@ -303,7 +345,7 @@ impl PerCoreScheduler {
 	}
 
 	#[cfg(feature = "newlib")]
-	fn clone_impl(&self, func: extern "C" fn(usize), arg: usize) -> TaskId {
+	fn clone_impl(&mut self, func: extern "C" fn(usize), arg: usize) -> TaskId {
 		static NEXT_CORE_ID: AtomicU32 = AtomicU32::new(1);
 
 		// Get the Core ID of the next CPU.
@@ -320,6 +362,10 @@ impl PerCoreScheduler {
 			}
 		};
 
+		// Get stacks for the cloned task.
+		let user_stack_size = self.current_task.borrow().stacks.get_user_stack_size();
+		let stacks = self.get_task_stacks(user_stack_size);
+
 		// Get the current task.
 		let current_task_borrowed = self.current_task.borrow();
 
@@ -331,14 +377,12 @@ impl PerCoreScheduler {
 			arg,
 			prio: current_task_borrowed.prio,
 			core_id,
-			stacks: TaskStacks::new(current_task_borrowed.stacks.get_user_stack_size()),
+			stacks,
 			object_map: current_task_borrowed.object_map.clone(),
 		};
 
 		// Add it to the task lists.
 		let wakeup = {
-			#[cfg(feature = "smp")]
-			let mut input_locked = get_scheduler_input(core_id).lock();
 			WAITING_TASKS.lock().insert(tid, VecDeque::with_capacity(1));
 			TASKS.lock().insert(
 				tid,
@@ -352,7 +396,10 @@ impl PerCoreScheduler {
 			NO_TASKS.fetch_add(1, Ordering::SeqCst);
 			#[cfg(feature = "smp")]
 			if core_id != core_scheduler().core_id {
-				input_locked.new_tasks.push_back(clone_task);
+				get_scheduler_input(core_id)
+					.new_tasks_sender
+					.try_send(clone_task)
+					.unwrap();
 				true
 			} else {
 				let clone_task = Rc::new(RefCell::new(Task::from(clone_task)));
@@ -378,7 +425,7 @@ impl PerCoreScheduler {
 	}
 
 	#[cfg(feature = "newlib")]
-	pub fn clone(&self, func: extern "C" fn(usize), arg: usize) -> TaskId {
+	pub fn clone(&mut self, func: extern "C" fn(usize), arg: usize) -> TaskId {
 		without_interrupts(|| self.clone_impl(func, arg))
 	}
 
@@ -416,9 +463,9 @@ impl PerCoreScheduler {
 			});
 		} else {
 			get_scheduler_input(task.get_core_id())
-				.lock()
-				.wakeup_tasks
-				.push_back(task);
+				.wakeup_tasks_sender
+				.try_send(task)
+				.unwrap();
 			// Wake up the CPU
 			arch::wakeup_core(task.get_core_id());
 		}
@@ -452,168 +499,30 @@ impl PerCoreScheduler {
 	}
 
 	#[inline]
-	pub fn get_current_task_object_map(
-		&self,
-	) -> Arc<async_lock::RwLock<HashMap<FileDescriptor, Arc<dyn ObjectInterface>, RandomState>>> {
+	pub fn get_current_task_object_map(&self) -> Arc<ObjectMap> {
 		without_interrupts(|| self.current_task.borrow().object_map.clone())
 	}
 
-	/// Map a file descriptor to their IO interface and returns
-	/// the shared reference
-	#[inline]
-	pub async fn get_object(
-		&self,
-		fd: FileDescriptor,
-	) -> Result<Arc<dyn ObjectInterface>, IoError> {
-		future::poll_fn(|cx| {
-			without_interrupts(|| {
-				let borrowed = self.current_task.borrow();
-				let mut pinned_obj = core::pin::pin!(borrowed.object_map.read());
-
-				let guard = ready!(pinned_obj.as_mut().poll(cx));
-				Ready(guard.get(&fd).cloned().ok_or(IoError::EINVAL))
-			})
-		})
-		.await
-	}
-
 	/// Creates a new map between file descriptor and their IO interface and
 	/// clone the standard descriptors.
 	#[allow(dead_code)]
-	pub async fn recreate_objmap(&self) -> Result<(), IoError> {
-		let mut map = HashMap::<FileDescriptor, Arc<dyn ObjectInterface>, RandomState>::with_hasher(
-			RandomState::with_seeds(0, 0, 0, 0),
-		);
-
-		future::poll_fn(|cx| {
-			without_interrupts(|| {
-				let borrowed = self.current_task.borrow();
-				let mut pinned_obj = core::pin::pin!(borrowed.object_map.read());
-
-				let guard = ready!(pinned_obj.as_mut().poll(cx));
-				// clone standard file descriptors
-				for i in 0..3 {
-					if let Some(obj) = guard.get(&i) {
-						map.insert(i, obj.clone());
-					}
-				}
-
-				Ready(Ok::<(), IoError>(()))
-			})
-		})
-		.await?;
+	pub fn recreate_objmap(&self) -> Result<(), IoError> {
+		let objmap = Arc::new(ObjectMap::new());
 
 		without_interrupts(|| {
-			self.current_task.borrow_mut().object_map = Arc::new(async_lock::RwLock::new(map));
+			let mut current_task = self.current_task.borrow_mut();
+			// clone standard file descriptors
+			for fd in 0..3 {
+				if let Ok(obj) = current_task.object_map.get_object(fd) {
+					objmap.replace_object(fd, obj).unwrap();
+				}
+			}
+			current_task.object_map = objmap;
 		});
 
 		Ok(())
 	}
 
-	/// Insert a new IO interface and returns a file descriptor as
-	/// identifier to this object
-	pub async fn insert_object(
-		&self,
-		obj: Arc<dyn ObjectInterface>,
-	) -> Result<FileDescriptor, IoError> {
-		future::poll_fn(|cx| {
-			without_interrupts(|| {
-				let borrowed = self.current_task.borrow();
-				let mut pinned_obj = core::pin::pin!(borrowed.object_map.write());
-
-				let mut guard = ready!(pinned_obj.as_mut().poll(cx));
-				let new_fd = || -> Result<FileDescriptor, IoError> {
-					let mut fd: FileDescriptor = 0;
-					loop {
-						if !guard.contains_key(&fd) {
-							break Ok(fd);
-						} else if fd == FileDescriptor::MAX {
-							break Err(IoError::EOVERFLOW);
-						}
-
-						fd = fd.saturating_add(1);
-					}
-				};
-
-				let fd = new_fd()?;
-				let _ = guard.insert(fd, obj.clone());
-				Ready(Ok(fd))
-			})
-		})
-		.await
-	}
-
-	/// Replace an existing IO interface by a new one
-	#[allow(dead_code)]
-	pub async fn replace_object(
-		&self,
-		fd: FileDescriptor,
-		obj: Arc<dyn ObjectInterface>,
-	) -> Result<(), IoError> {
-		future::poll_fn(|cx| {
-			without_interrupts(|| {
-				let borrowed = self.current_task.borrow();
-				let mut pinned_obj = core::pin::pin!(borrowed.object_map.write());
-
-				let mut guard = ready!(pinned_obj.as_mut().poll(cx));
-				guard.insert(fd, obj.clone());
-				Ready(Ok(()))
-			})
-		})
-		.await
-	}
-
-	/// Duplicate a IO interface and returns a new file descriptor as
-	/// identifier to the new copy
-	pub async fn dup_object(&self, fd: FileDescriptor) -> Result<FileDescriptor, IoError> {
-		future::poll_fn(|cx| {
-			without_interrupts(|| {
-				let borrowed = self.current_task.borrow();
-				let mut pinned_obj = core::pin::pin!(borrowed.object_map.write());
-
-				let mut guard = ready!(pinned_obj.as_mut().poll(cx));
-				let obj = (*(guard.get(&fd).ok_or(IoError::EINVAL)?)).clone();
-
-				let new_fd = || -> Result<FileDescriptor, IoError> {
-					let mut fd: FileDescriptor = 0;
-					loop {
-						if !guard.contains_key(&fd) {
-							break Ok(fd);
-						} else if fd == FileDescriptor::MAX {
-							break Err(IoError::EOVERFLOW);
-						}
-
-						fd = fd.saturating_add(1);
-					}
-				};
-
-				let fd = new_fd()?;
-				if guard.try_insert(fd, obj).is_err() {
-					Ready(Err(IoError::EMFILE))
-				} else {
-					Ready(Ok(fd))
-				}
-			})
-		})
-		.await
-	}
-
-	/// Remove a IO interface, which is named by the file descriptor
-	pub async fn remove_object(
-		&self,
-		fd: FileDescriptor,
-	) -> Result<Arc<dyn ObjectInterface>, IoError> {
-		future::poll_fn(|cx| {
-			without_interrupts(|| {
-				let borrowed = self.current_task.borrow();
-				let mut pinned_obj = core::pin::pin!(borrowed.object_map.write());
-				let mut guard = ready!(pinned_obj.as_mut().poll(cx));
-				Ready(guard.remove(&fd).ok_or(IoError::EINVAL))
-			})
-		})
-		.await
-	}
-
 	#[inline]
 	pub fn get_current_task_prio(&self) -> Priority {
 		without_interrupts(|| self.current_task.borrow().prio)
@@ -705,27 +614,115 @@ impl PerCoreScheduler {
 		}
 	}
 
+	/// Takes fitting stacks from the stack pool or allocates fresh ones.
+	fn get_task_stacks(&mut self, stack_size: usize) -> TaskStacks {
+		if let Some(index) = self
+			.stack_pool
+			.iter()
+			.position(|stacks| stacks.get_user_stack_size() >= stack_size)
+		{
+			self.stack_pool.swap_remove(index)
+		} else {
+			TaskStacks::new(stack_size)
+		}
+	}
+
 	/// Check if a finished task could be deleted.
 	fn cleanup_tasks(&mut self) {
 		// Pop the first finished task and remove it from the TASKS list, which implicitly deallocates all associated memory.
 		while let Some(finished_task) = self.finished_tasks.pop_front() {
 			debug!("Cleaning up task {}", finished_task.borrow().id);
+
+			// Keep the task's stacks for reuse, as mapping fresh stacks
+			// dominates the cost of spawning a task. Surplus stacks are
+			// dropped and give their memory back to the system.
+			if self.stack_pool.len() < STACK_POOL_SIZE {
+				if let Ok(task) = Rc::try_unwrap(finished_task) {
+					self.stack_pool.push(task.into_inner().stacks);
+				}
+			}
 		}
 	}
 
 	#[cfg(all(any(target_arch = "x86_64", target_arch = "riscv64"), feature = "smp"))]
 	pub fn check_input(&mut self) {
-		let mut input_locked = CoreLocal::get().scheduler_input.lock();
+		let input = CoreLocal::get().scheduler_input.get().unwrap();
 
-		while let Some(task) = input_locked.wakeup_tasks.pop_front() {
+		while let Ok(task) = input.wakeup_tasks_receiver.try_recv() {
 			let task = self.blocked_tasks.custom_wakeup(task);
 			self.ready_queue.push(task);
 		}
 
-		while let Some(new_task) = input_locked.new_tasks.pop_front() {
+		while let Ok(new_task) = input.new_tasks_receiver.try_recv() {
 			let task = Rc::new(RefCell::new(Task::from(new_task)));
 			self.ready_queue.push(task.clone());
 		}
+
+		#[cfg(target_arch = "x86_64")]
+		while let Ok(MigratedTask(task)) = input.migrated_tasks_receiver.try_recv() {
+			self.ready_queue.push(Rc::new(RefCell::new(task)));
+		}
+
+		while let Ok(task) = input.async_tasks_receiver.try_recv() {
+			async_tasks().push(task);
+		}
+	}
+
+	/// Offloads a surplus ready task to a halted core, if there is one.
+	///
+	/// Tasks can only be migrated while they are ready: their stacks and
+	/// thread-local storage stay valid on every core, while the state of
+	/// blocked or running tasks partially lives in this core's registers.
+	#[cfg(all(target_arch = "x86_64", feature = "smp"))]
+	fn balance(&mut self) {
+		// Keep at least one ready task on this core.
+		if self.ready_queue.len() < 2 {
+			return;
+		}
+
+		let Some(core_id) = get_idle_core(self.core_id) else {
+			return;
+		};
+
+		let Some(task) = self.ready_queue.pop() else {
+			return;
+		};
+
+		// Tasks that already ran are bound to this core: their stacks may
+		// reference core-local structures (the futex code for example
+		// keeps the scheduler reference across blocking) and the FPU
+		// owner's state only lives in this core's FPU registers.
+		if task.borrow().has_run {
+			self.ready_queue.push(task);
+			return;
+		}
+
+		let mut task = match Rc::try_unwrap(task) {
+			Ok(task) => task.into_inner(),
+			Err(task) => {
+				// Someone else still references the task, so it cannot
+				// be moved to another core.
+				self.ready_queue.push(task);
+				return;
+			}
+		};
+
+		debug!(
+			"Migrating task {} from core {} to core {}",
+			task.id, self.core_id, core_id
+		);
+		task.core_id = core_id;
+
+		TASKS
+			.lock()
+			.insert(task.id, TaskHandle::new(task.id, task.prio, core_id));
+		get_scheduler_input(core_id)
+			.migrated_tasks_sender
+			.try_send(MigratedTask(task))
+			.unwrap();
+
+		// Wake up the CPU
+		arch::wakeup_core(core_id);
 	}
 
 	/// Only the idle task should call this function.
@@ -778,6 +775,10 @@ impl PerCoreScheduler {
 		// => we have time to cleanup the system
 		self.cleanup_tasks();
 
+		// If another core ran out of work, hand over a surplus ready task.
+		#[cfg(all(target_arch = "x86_64", feature = "smp"))]
+		self.balance();
+
 		// Get information about the current task.
 		let (id, last_stack_pointer, prio, status) = {
 			let mut borrowed = self.current_task.borrow_mut();
@@ -833,12 +834,22 @@ impl PerCoreScheduler {
 				if borrowed.status != TaskStatus::Idle {
 					// Mark the new task as running.
 					borrowed.status = TaskStatus::Running;
+					#[cfg(all(target_arch = "x86_64", feature = "smp"))]
+					{
+						borrowed.has_run = true;
+					}
 				}
 
 				(borrowed.id, borrowed.last_stack_pointer)
 			};
 
 			if id != new_id {
+				crate::instrumentation::tracepoint(
+					crate::instrumentation::TracepointKind::ContextSwitch,
+					id.into() as u64,
+					new_id.into() as u64,
+				);
+
 				// Tell the scheduler about the new task.
 				debug!(
 					"Switching task from {} to {} (stack {:#X} => {:p})",
@@ -924,6 +935,7 @@ pub(crate) fn add_current_core() {
 		ready_queue: PriorityTaskQueue::new(),
 		finished_tasks: VecDeque::new(),
 		blocked_tasks: BlockedTaskQueue::new(),
+		stack_pool: Vec::new(),
 	});
 
 	let scheduler = Box::into_raw(boxed_scheduler);
@@ -932,7 +944,9 @@ pub(crate) fn add_current_core() {
 	{
 		SCHEDULER_INPUTS.lock().insert(
 			core_id.try_into().unwrap(),
-			&CoreLocal::get().scheduler_input,
+			CoreLocal::get()
+				.scheduler_input
+				.get_or_init(SchedulerInput::new),
 		);
 		#[cfg(target_arch = "x86_64")]
 		CORE_HLT_STATE
@@ -949,10 +963,37 @@ pub(crate) fn take_core_hlt_state(core_id: CoreId) -> bool {
 
 #[inline]
 #[cfg(feature = "smp")]
-fn get_scheduler_input(core_id: CoreId) -> &'static InterruptTicketMutex<SchedulerInput> {
+fn get_scheduler_input(core_id: CoreId) -> &'static SchedulerInput {
 	SCHEDULER_INPUTS.lock()[usize::try_from(core_id).unwrap()]
 }
 
+/// Queues an async task to be run by the executor of the given core.
+#[cfg(all(any(target_arch = "x86_64", target_arch = "riscv64"), feature = "smp"))]
+pub(crate) fn spawn_async_task(task: AsyncTask, core_id: CoreId) {
+	if core_id == crate::arch::core_local::core_id() {
+		without_interrupts(|| async_tasks().push(task));
+	} else {
+		get_scheduler_input(core_id)
+			.async_tasks_sender
+			.try_send(task)
+			.unwrap();
+		// Wake up the CPU
+		arch::wakeup_core(core_id);
+	}
+}
+
+/// Returns the ID of a halted core other than `core_id`, if there is one.
+#[inline]
+#[cfg(all(target_arch = "x86_64", feature = "smp"))]
+fn get_idle_core(core_id: CoreId) -> Option<CoreId> {
+	CORE_HLT_STATE
+		.lock()
+		.iter()
+		.enumerate()
+		.find(|(id, hlt)| *id != usize::try_from(core_id).unwrap() && hlt.load(Ordering::Relaxed))
+		.map(|(id, _)| CoreId::try_from(id).unwrap())
+}
+
 pub unsafe fn spawn(
 	func: unsafe extern "C" fn(usize),
 	arg: usize,
@@ -10,11 +10,9 @@ use core::cell::RefCell;
 use core::num::NonZeroU64;
 #[cfg(any(feature = "tcp", feature = "udp"))]
 use core::ops::DerefMut;
-use core::{cmp, fmt};
+use core::{cmp, fmt, mem};
 
-use ahash::RandomState;
 use crossbeam_utils::CachePadded;
-use hashbrown::HashMap;
 use hermit_sync::OnceCell;
 
 use crate::arch::core_local::*;
@@ -22,11 +20,8 @@ use crate::arch::mm::VirtAddr;
 use crate::arch::scheduler::TaskStacks;
 #[cfg(not(feature = "common-os"))]
 use crate::arch::scheduler::TaskTLS;
-use crate::executor::poll_on;
 use crate::fd::stdio::*;
-use crate::fd::{
-	FileDescriptor, IoError, ObjectInterface, STDERR_FILENO, STDIN_FILENO, STDOUT_FILENO,
-};
+use crate::fd::{ObjectMap, STDERR_FILENO, STDIN_FILENO, STDOUT_FILENO};
 use crate::scheduler::CoreId;
 use crate::{arch, env};
 
@@ -318,6 +313,12 @@ impl PriorityTaskQueue {
 		self.prio_bitmap == 0
 	}
 
+	/// Returns the number of tasks in the queue.
+	#[cfg(all(target_arch = "x86_64", feature = "smp"))]
+	pub fn len(&self) -> usize {
+		self.queues.iter().map(LinkedList::len).sum()
+	}
+
 	/// Returns reference to prio_bitmap
 	#[allow(dead_code)]
 	#[inline]
@@ -396,11 +397,13 @@ pub(crate) struct Task {
 	pub last_fpu_state: arch::processor::FPUState,
 	/// ID of the core this task is running on
 	pub core_id: CoreId,
+	/// Whether the task has already been running on some core
+	#[cfg(all(target_arch = "x86_64", feature = "smp"))]
+	pub has_run: bool,
 	/// Stack of the task
 	pub stacks: TaskStacks,
 	/// Mapping between file descriptor and the referenced IO interface
-	pub object_map:
-		Arc<async_lock::RwLock<HashMap<FileDescriptor, Arc<dyn ObjectInterface>, RandomState>>>,
+	pub object_map: Arc<ObjectMap>,
 	/// Task Thread-Local-Storage (TLS)
 	#[cfg(not(feature = "common-os"))]
 	pub tls: Option<Box<TaskTLS>>,
@@ -421,9 +424,7 @@ impl Task {
 		task_status: TaskStatus,
 		task_prio: Priority,
 		stacks: TaskStacks,
-		object_map: Arc<
-			async_lock::RwLock<HashMap<FileDescriptor, Arc<dyn ObjectInterface>, RandomState>>,
-		>,
+		object_map: Arc<ObjectMap>,
 	) -> Task {
 		debug!("Creating new task {} on core {}", tid, core_id);
 
@@ -436,6 +437,8 @@ impl Task {
 			#[cfg(any(target_arch = "x86_64", target_arch = "riscv64"))]
 			last_fpu_state: arch::processor::FPUState::new(),
 			core_id,
+			#[cfg(all(target_arch = "x86_64", feature = "smp"))]
+			has_run: false,
 			stacks,
 			object_map,
 			#[cfg(not(feature = "common-os"))]
@@ -449,50 +452,32 @@ impl Task {
 		debug!("Creating idle task {}", tid);
 
 		/// All cores use the same mapping between file descriptor and the referenced object
-		static OBJECT_MAP: OnceCell<
-			Arc<async_lock::RwLock<HashMap<FileDescriptor, Arc<dyn ObjectInterface>, RandomState>>>,
-		> = OnceCell::new();
+		static OBJECT_MAP: OnceCell<Arc<ObjectMap>> = OnceCell::new();
 
 		if core_id == 0 {
-			OBJECT_MAP
-				.set(Arc::new(async_lock::RwLock::new(HashMap::<
-					FileDescriptor,
-					Arc<dyn ObjectInterface>,
-					RandomState,
-				>::with_hasher(
-					RandomState::with_seeds(0, 0, 0, 0),
-				))))
-				.unwrap();
-			let objmap = OBJECT_MAP.get().unwrap().clone();
-			let _ = poll_on(
-				async {
-					let mut guard = objmap.write().await;
-					if env::is_uhyve() {
-						guard
-							.try_insert(STDIN_FILENO, Arc::new(UhyveStdin::new()))
-							.map_err(|_| IoError::EIO)?;
-						guard
-							.try_insert(STDOUT_FILENO, Arc::new(UhyveStdout::new()))
-							.map_err(|_| IoError::EIO)?;
-						guard
-							.try_insert(STDERR_FILENO, Arc::new(UhyveStderr::new()))
-							.map_err(|_| IoError::EIO)?;
-					} else {
-						guard
-							.try_insert(STDIN_FILENO, Arc::new(GenericStdin::new()))
-							.map_err(|_| IoError::EIO)?;
-						guard
-							.try_insert(STDOUT_FILENO, Arc::new(GenericStdout::new()))
-							.map_err(|_| IoError::EIO)?;
-						guard
-							.try_insert(STDERR_FILENO, Arc::new(GenericStderr::new()))
-							.map_err(|_| IoError::EIO)?;
-					}
-
-					Ok(())
-				},
-				None,
-			);
+			OBJECT_MAP.set(Arc::new(ObjectMap::new())).unwrap();
+			let objmap = OBJECT_MAP.get().unwrap();
+			if env::is_uhyve() {
+				objmap
+					.replace_object(STDIN_FILENO, Arc::new(UhyveStdin::new()))
+					.unwrap();
+				objmap
+					.replace_object(STDOUT_FILENO, Arc::new(UhyveStdout::new()))
+					.unwrap();
+				objmap
+					.replace_object(STDERR_FILENO, Arc::new(UhyveStderr::new()))
+					.unwrap();
+			} else {
+				objmap
+					.replace_object(STDIN_FILENO, Arc::new(GenericStdin::new()))
+					.unwrap();
+				objmap
+					.replace_object(STDOUT_FILENO, Arc::new(GenericStdout::new()))
+					.unwrap();
+				objmap
+					.replace_object(STDERR_FILENO, Arc::new(GenericStderr::new()))
+					.unwrap();
+			}
 		}
 
 		Task {
@@ -504,6 +489,8 @@ impl Task {
 			#[cfg(any(target_arch = "x86_64", target_arch = "riscv64"))]
 			last_fpu_state: arch::processor::FPUState::new(),
 			core_id,
+			#[cfg(all(target_arch = "x86_64", feature = "smp"))]
+			has_run: true,
 			stacks: TaskStacks::from_boot_stacks(),
 			object_map: OBJECT_MAP.get().unwrap().clone(),
 			#[cfg(not(feature = "common-os"))]
@@ -520,19 +507,175 @@ impl Task {
 	}
 }*/
 
-struct BlockedTask {
+/// Number of bits by which the slot size grows from one timer wheel level to
+/// the next, i.e. the binary logarithm of [`WHEEL_SLOTS`].
+const WHEEL_SLOT_BITS: u32 = 6;
+/// Number of slots per timer wheel level.
+const WHEEL_SLOTS: usize = 1 << WHEEL_SLOT_BITS;
+/// Number of levels of the timer wheel.
+const WHEEL_LEVELS: usize = 4;
+
+/// A task that is blocked until a given point in time.
+struct WheelEntry {
 	task: Rc<RefCell<Task>>,
-	wakeup_time: Option<u64>,
+	wakeup_time: u64,
 }
 
-impl BlockedTask {
-	pub fn new(task: Rc<RefCell<Task>>, wakeup_time: Option<u64>) -> Self {
-		Self { task, wakeup_time }
+/// A hierarchical timer wheel holding the blocked tasks of a core that have a
+/// wakeup time.
+///
+/// Level `l` groups the wakeup times into slots of `WHEEL_SLOTS.pow(l)` timer
+/// ticks each, so arming a timer is a constant-time insertion into the slot
+/// that its wakeup time falls into, no matter how many timers are armed.
+/// Wakeup times beyond the range of the last level alias into its slots; since
+/// expiry re-checks every entry of an expired slot against the clock and
+/// re-inserts the entries that are still pending, such entries simply cascade
+/// through the wheel until their time has come.
+struct TimerWheel {
+	/// The slots of all levels, holding the blocked tasks.
+	slots: [[Vec<WheelEntry>; WHEEL_SLOTS]; WHEEL_LEVELS],
+	/// Per-level bitmap of the slots that are non-empty.
+	occupied: [u64; WHEEL_LEVELS],
+	/// The point in time up to which the wheel has been advanced.
+	current: u64,
+}
+
+impl TimerWheel {
+	pub const fn new() -> Self {
+		Self {
+			slots: [const { [const { Vec::new() }; WHEEL_SLOTS] }; WHEEL_LEVELS],
+			occupied: [0; WHEEL_LEVELS],
+			current: 0,
+		}
+	}
+
+	/// Returns the level and slot that the given wakeup time falls into.
+	fn position(&self, wakeup_time: u64) -> (usize, usize) {
+		let delta = wakeup_time.saturating_sub(self.current);
+		let level = if delta == 0 {
+			0
+		} else {
+			cmp::min(
+				((u64::BITS - 1 - delta.leading_zeros()) / WHEEL_SLOT_BITS) as usize,
+				WHEEL_LEVELS - 1,
+			)
+		};
+		let slot = (wakeup_time >> (WHEEL_SLOT_BITS * level as u32)) as usize & (WHEEL_SLOTS - 1);
+		(level, slot)
+	}
+
+	/// Inserts a blocked task that shall be woken up at `wakeup_time`.
+	pub fn insert(&mut self, task: Rc<RefCell<Task>>, wakeup_time: u64) {
+		let (level, slot) = self.position(wakeup_time);
+		self.slots[level][slot].push(WheelEntry { task, wakeup_time });
+		self.occupied[level] |= 1 << slot;
+	}
+
+	/// Removes the blocked task with the given ID from the wheel, if present.
+	pub fn remove(&mut self, id: TaskId) -> Option<Rc<RefCell<Task>>> {
+		for level in 0..WHEEL_LEVELS {
+			let mut occupied = self.occupied[level];
+			while occupied != 0 {
+				let slot = occupied.trailing_zeros() as usize;
+				occupied &= occupied - 1;
+
+				let entries = &mut self.slots[level][slot];
+				if let Some(i) = entries
+					.iter()
+					.position(|entry| entry.task.borrow().id == id)
+				{
+					let entry = entries.swap_remove(i);
+					if entries.is_empty() {
+						self.occupied[level] &= !(1 << slot);
+					}
+					return Some(entry.task);
+				}
+			}
+		}
+
+		None
+	}
+
+	/// Advances the wheel to `time` and collects the tasks whose wakeup time
+	/// has elapsed into `expired`.
+	pub fn advance(&mut self, time: u64, expired: &mut Vec<Rc<RefCell<Task>>>) {
+		if time <= self.current {
+			return;
+		}
+
+		let mut drained = Vec::new();
+		for level in 0..WHEEL_LEVELS {
+			let shift = WHEEL_SLOT_BITS * level as u32;
+			let first = self.current >> shift;
+			let last = time >> shift;
+
+			if last - first >= WHEEL_SLOTS as u64 {
+				// The level has been passed in its entirety; drain all of its slots.
+				let mut occupied = mem::take(&mut self.occupied[level]);
+				while occupied != 0 {
+					let slot = occupied.trailing_zeros() as usize;
+					occupied &= occupied - 1;
+					drained.append(&mut self.slots[level][slot]);
+				}
+			} else {
+				for n in first..=last {
+					let slot = n as usize & (WHEEL_SLOTS - 1);
+					if self.occupied[level] & (1 << slot) != 0 {
+						self.occupied[level] &= !(1 << slot);
+						drained.append(&mut self.slots[level][slot]);
+					}
+				}
+			}
+		}
+
+		self.current = time;
+
+		// The slots of the higher levels are coarser than a tick, so not every
+		// entry of a drained slot has elapsed yet. Re-inserting the pending
+		// ones cascades them towards the first level.
+		for entry in drained {
+			if entry.wakeup_time <= time {
+				expired.push(entry.task);
+			} else {
+				self.insert(entry.task, entry.wakeup_time);
+			}
+		}
+	}
+
+	/// Returns the point in time at which the earliest armed timer elapses,
+	/// if any.
+	///
+	/// The returned time is the start of the earliest non-empty slot and can
+	/// precede the wakeup times of the entries within it, in which case they
+	/// are simply re-inserted when the wheel is advanced.
+	pub fn next_wakeup(&self) -> Option<u64> {
+		let mut next: Option<u64> = None;
+
+		for level in 0..WHEEL_LEVELS {
+			if self.occupied[level] == 0 {
+				continue;
+			}
+
+			let shift = WHEEL_SLOT_BITS * level as u32;
+			let first = self.current >> shift;
+			// Rotate the bitmap so that the bit of the slot holding `current`
+			// becomes the least significant one and the distance to the next
+			// occupied slot can be read off the trailing zeros.
+			let rotated =
+				self.occupied[level].rotate_right(first as u32 & (WHEEL_SLOTS as u32 - 1));
+			let time = (first + u64::from(rotated.trailing_zeros())) << shift;
+			next = Some(next.map_or(time, |next| cmp::min(next, time)));
+		}
+
+		next
 	}
 }
 
 pub(crate) struct BlockedTaskQueue {
-	list: LinkedList<BlockedTask>,
+	/// Blocked tasks without a wakeup time.
+	indefinite: LinkedList<Rc<RefCell<Task>>>,
+	/// Blocked tasks with a wakeup time.
+	wheel: TimerWheel,
 	#[cfg(any(feature = "tcp", feature = "udp"))]
 	network_wakeup_time: Option<u64>,
 }
@@ -540,7 +683,8 @@ pub(crate) struct BlockedTaskQueue {
 impl BlockedTaskQueue {
 	pub const fn new() -> Self {
 		Self {
-			list: LinkedList::new(),
+			indefinite: LinkedList::new(),
+			wheel: TimerWheel::new(),
 			#[cfg(any(feature = "tcp", feature = "udp"))]
 			network_wakeup_time: None,
 		}
@@ -569,18 +713,23 @@ impl BlockedTaskQueue {
 		borrowed.status = TaskStatus::Ready;
 	}
 
-	#[cfg(any(feature = "tcp", feature = "udp"))]
-	pub fn add_network_timer(&mut self, wakeup_time: Option<u64>) {
-		self.network_wakeup_time = wakeup_time;
-
-		let next = self.list.front().and_then(|t| t.wakeup_time);
+	/// Programs the one-shot timer to fire at the earliest wakeup time.
+	fn set_oneshot_timer(&self) {
+		let next = self.wheel.next_wakeup();
 
-		let time = match (wakeup_time, next) {
+		#[cfg(any(feature = "tcp", feature = "udp"))]
+		let next = match (next, self.network_wakeup_time) {
 			(Some(a), Some(b)) => Some(a.min(b)),
 			(a, b) => a.or(b),
 		};
 
-		arch::set_oneshot_timer(time);
+		arch::set_oneshot_timer(next);
+	}
+
+	#[cfg(any(feature = "tcp", feature = "udp"))]
+	pub fn add_network_timer(&mut self, wakeup_time: Option<u64>) {
+		self.network_wakeup_time = wakeup_time;
+		self.set_oneshot_timer();
 	}
 
 	/// Blocks the given task for `wakeup_time` ticks, or indefinitely if None is given.
@@ -599,50 +748,17 @@ impl BlockedTaskQueue {
 			borrowed.status = TaskStatus::Blocked;
 		}
 
-		let new_node = BlockedTask::new(task, wakeup_time);
-
 		// Shall the task automatically be woken up after a certain time?
 		if let Some(wt) = wakeup_time {
-			let mut cursor = self.list.cursor_front_mut();
-			let set_oneshot_timer = || {
-				#[cfg(not(any(feature = "tcp", feature = "udp")))]
-				arch::set_oneshot_timer(wakeup_time);
-				#[cfg(any(feature = "tcp", feature = "udp"))]
-				match self.network_wakeup_time {
-					Some(time) => {
-						if time > wt {
-							arch::set_oneshot_timer(wakeup_time);
-						} else {
-							arch::set_oneshot_timer(self.network_wakeup_time);
-						}
-					}
-					_ => arch::set_oneshot_timer(wakeup_time),
-				}
-			};
-
-			while let Some(node) = cursor.current() {
-				let node_wakeup_time = node.wakeup_time;
-				if node_wakeup_time.is_none() || wt < node_wakeup_time.unwrap() {
-					cursor.insert_before(new_node);
-
-					set_oneshot_timer();
-					return;
-				}
-
-				cursor.move_next();
-			}
-
-			set_oneshot_timer();
+			self.wheel.insert(task, wt);
+			self.set_oneshot_timer();
+		} else {
+			self.indefinite.push_back(task);
 		}
-
-		self.list.push_back(new_node);
 	}
 
 	/// Manually wake up a blocked task.
 	pub fn custom_wakeup(&mut self, task: TaskHandle) -> Rc<RefCell<Task>> {
-		let mut first_task = true;
-		let mut cursor = self.list.cursor_front_mut();
-
 		#[cfg(any(feature = "tcp", feature = "udp"))]
 		if let Some(wakeup_time) = self.network_wakeup_time {
 			if wakeup_time <= arch::processor::get_timer_ticks() {
@@ -650,54 +766,27 @@ impl BlockedTaskQueue {
 			}
 		}
 
-		// Loop through all blocked tasks to find it.
+		// Most custom wakeups target tasks that block without a timeout.
+		let mut cursor = self.indefinite.cursor_front_mut();
 		while let Some(node) = cursor.current() {
-			if node.task.borrow().id == task.get_id() {
-				// Remove it from the list of blocked tasks.
-				let task_ref = node.task.clone();
-				cursor.remove_current();
-
-				// If this is the first task, adjust the One-Shot Timer to fire at the
-				// next task's wakeup time (if any).
-				#[cfg(any(feature = "tcp", feature = "udp"))]
-				if first_task {
-					arch::set_oneshot_timer(cursor.current().map_or_else(
-						|| self.network_wakeup_time,
-						|node| match node.wakeup_time {
-							Some(wt) => {
-								if let Some(timer) = self.network_wakeup_time {
-									if wt < timer {
-										Some(wt)
-									} else {
-										Some(timer)
-									}
-								} else {
-									Some(wt)
-								}
-							}
-							None => self.network_wakeup_time,
-						},
-					));
-				}
-				#[cfg(not(any(feature = "tcp", feature = "udp")))]
-				if first_task {
-					arch::set_oneshot_timer(
-						cursor
-							.current()
-							.map_or_else(|| None, |node| node.wakeup_time),
-					);
-				}
-
-				// Wake it up.
+			if node.borrow().id == task.get_id() {
+				let task_ref = cursor.remove_current().unwrap();
 				Self::wakeup_task(task_ref.clone());
-
 				return task_ref;
 			}
 
-			first_task = false;
 			cursor.move_next();
 		}
 
+		if let Some(task_ref) = self.wheel.remove(task.get_id()) {
+			// The removed timer may have been the earliest one, so adjust the
+			// One-Shot Timer to fire at the next wakeup time (if any).
+			self.set_oneshot_timer();
+
+			Self::wakeup_task(task_ref.clone());
+			return task_ref;
+		}
+
 		unreachable!();
 	}
 
@@ -719,46 +808,9 @@ impl BlockedTaskQueue {
 		}
 
 		let mut tasks = vec![];
+		self.wheel.advance(time, &mut tasks);
 
-		// Loop through all blocked tasks.
-		let mut cursor = self.list.cursor_front_mut();
-		while let Some(node) = cursor.current() {
-			// Get the wakeup time of this task and check if we have reached the first task
-			// that hasn't elapsed yet or waits indefinitely.
-			let node_wakeup_time = node.wakeup_time;
-			if node_wakeup_time.is_none() || time < node_wakeup_time.unwrap() {
-				break;
-			}
-
-			// Otherwise, this task has elapsed, so remove it from the list and wake it up.
-			tasks.push(node.task.clone());
-			cursor.remove_current();
-		}
-
-		#[cfg(any(feature = "tcp", feature = "udp"))]
-		arch::set_oneshot_timer(cursor.current().map_or_else(
-			|| self.network_wakeup_time,
-			|node| match node.wakeup_time {
-				Some(wt) => {
-					if let Some(timer) = self.network_wakeup_time {
-						if wt < timer {
-							Some(wt)
-						} else {
-							Some(timer)
-						}
-					} else {
-						Some(wt)
-					}
-				}
-				None => self.network_wakeup_time,
-			},
-		));
-		#[cfg(not(any(feature = "tcp", feature = "udp")))]
-		arch::set_oneshot_timer(
-			cursor
-				.current()
-				.map_or_else(|| None, |node| node.wakeup_time),
-		);
+		self.set_oneshot_timer();
 
 		for task in tasks.iter().cloned() {
 			Self::wakeup_task(task);
@@ -34,6 +34,17 @@ static mut SHELL: Lazy<Shell<'_>> = Lazy::new(|| {
 			aliases: &["i"],
 		},
 	);
+	shell.commands.insert(
+		"trace",
+		ShellCommand {
+			help: "Shows the tracepoint counters of all cores",
+			func: |_, shell| {
+				crate::instrumentation::print_statistics();
+				Ok(())
+			},
+			aliases: &["t"],
+		},
+	);
 	shell.commands.insert(
 		"shutdown",
 		ShellCommand {
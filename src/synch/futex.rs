@@ -1,7 +1,9 @@
+use core::hash::BuildHasher;
 use core::sync::atomic::AtomicU32;
 use core::sync::atomic::Ordering::SeqCst;
 
 use ahash::RandomState;
+use crossbeam_utils::CachePadded;
 use hashbrown::hash_map::Entry;
 use hashbrown::HashMap;
 use hermit_sync::InterruptTicketMutex;
@@ -12,9 +14,30 @@ use crate::errno::{EAGAIN, EINVAL, ETIMEDOUT};
 use crate::scheduler::task::TaskHandlePriorityQueue;
 use crate::scheduler::PerCoreSchedulerExt;
 
-// TODO: Replace with a concurrent hashmap.
-static PARKING_LOT: InterruptTicketMutex<HashMap<usize, TaskHandlePriorityQueue, RandomState>> =
-	InterruptTicketMutex::new(HashMap::with_hasher(RandomState::with_seeds(0, 0, 0, 0)));
+type Bucket = InterruptTicketMutex<HashMap<usize, TaskHandlePriorityQueue, RandomState>>;
+
+/// The number of buckets in the parking lot.
+///
+/// Must be a power of two.
+const BUCKET_COUNT: usize = 64;
+
+// The parking lot is sharded into independently locked buckets indexed by a
+// hash of the futex address (like Linux' futex hash buckets), so that
+// unrelated futexes do not contend on a single lock.
+// TODO: Replace the buckets with a concurrent hashmap.
+static PARKING_LOT: [CachePadded<Bucket>; BUCKET_COUNT] = {
+	#[allow(clippy::declare_interior_mutable_const)]
+	const BUCKET: CachePadded<Bucket> = CachePadded::new(InterruptTicketMutex::new(
+		HashMap::with_hasher(RandomState::with_seeds(0, 0, 0, 0)),
+	));
+	[BUCKET; BUCKET_COUNT]
+};
+
+/// Returns the parking lot bucket responsible for the futex at `address`.
+fn bucket(address: usize) -> &'static Bucket {
+	let hash = RandomState::with_seeds(0, 0, 0, 0).hash_one(address);
+	&PARKING_LOT[hash as usize & (BUCKET_COUNT - 1)]
+}
 
 bitflags! {
 	pub struct Flags: u32 {
@@ -40,7 +63,13 @@ pub(crate) fn futex_wait(
 	timeout: Option<u64>,
 	flags: Flags,
 ) -> i32 {
-	let mut parking_lot = PARKING_LOT.lock();
+	crate::instrumentation::tracepoint(
+		crate::instrumentation::TracepointKind::FutexWait,
+		addr(address) as u64,
+		0,
+	);
+
+	let mut parking_lot = bucket(addr(address)).lock();
 	// Check the futex value after locking the parking lot so that all changes are observed.
 	if address.load(SeqCst) != expected {
 		return -EAGAIN;
@@ -61,7 +90,7 @@ pub(crate) fn futex_wait(
 	loop {
 		scheduler.reschedule();
 
-		let mut parking_lot = PARKING_LOT.lock();
+		let mut parking_lot = bucket(addr(address)).lock();
 		if matches!(wakeup_time, Some(t) if t <= get_timer_ticks()) {
 			let mut wakeup = true;
 			// Timeout occurred, try to remove ourselves from the waiting queue.
@@ -109,7 +138,7 @@ pub(crate) fn futex_wait_and_set(
 	flags: Flags,
 	new_value: u32,
 ) -> i32 {
-	let mut parking_lot = PARKING_LOT.lock();
+	let mut parking_lot = bucket(addr(address)).lock();
 	// Check the futex value after locking the parking lot so that all changes are observed.
 	if address.swap(new_value, SeqCst) != expected {
 		return -EAGAIN;
@@ -130,7 +159,7 @@ pub(crate) fn futex_wait_and_set(
 	loop {
 		scheduler.reschedule();
 
-		let mut parking_lot = PARKING_LOT.lock();
+		let mut parking_lot = bucket(addr(address)).lock();
 		if matches!(wakeup_time, Some(t) if t <= get_timer_ticks()) {
 			let mut wakeup = true;
 			// Timeout occurred, try to remove ourselves from the waiting queue.
@@ -172,7 +201,13 @@ pub(crate) fn futex_wake(address: &AtomicU32, count: i32) -> i32 {
 		return -EINVAL;
 	}
 
-	let mut parking_lot = PARKING_LOT.lock();
+	crate::instrumentation::tracepoint(
+		crate::instrumentation::TracepointKind::FutexWake,
+		addr(address) as u64,
+		count as u64,
+	);
+
+	let mut parking_lot = bucket(addr(address)).lock();
 	let mut queue = match parking_lot.entry(addr(address)) {
 		Entry::Occupied(entry) => entry,
 		Entry::Vacant(_) => return 0,
@@ -204,7 +239,7 @@ pub(crate) fn futex_wake_or_set(address: &AtomicU32, count: i32, new_value: u32)
 		return -EINVAL;
 	}
 
-	let mut parking_lot = PARKING_LOT.lock();
+	let mut parking_lot = bucket(addr(address)).lock();
 	let mut queue = match parking_lot.entry(addr(address)) {
 		Entry::Occupied(entry) => entry,
 		Entry::Vacant(_) => {
@@ -5,6 +5,8 @@ use crate::arch;
 use crate::arch::mm::paging::PageTableEntryFlagsExt;
 use crate::arch::mm::paging::{BasePageSize, PageSize, PageTableEntryFlags};
 use crate::arch::mm::VirtAddr;
+#[cfg(all(target_arch = "x86_64", not(feature = "common-os")))]
+use crate::mm::demand_paging;
 
 bitflags! {
 	#[repr(transparent)]
@@ -21,6 +23,19 @@ bitflags! {
 	}
 }
 
+fn page_table_entry_flags(prot_flags: MemoryProtection) -> PageTableEntryFlags {
+	let mut flags = PageTableEntryFlags::empty();
+	flags.normal().writable();
+	if prot_flags.contains(MemoryProtection::Write) {
+		flags.writable();
+	}
+	if !prot_flags.contains(MemoryProtection::Exec) {
+		flags.execute_disable();
+	}
+
+	flags
+}
+
 /// Creates a new virtual memory mapping of the `size` specified with
 /// protection bits specified in `prot_flags`.
 #[hermit_macro::system]
@@ -32,19 +47,26 @@ pub extern "C" fn sys_mmap(size: usize, prot_flags: MemoryProtection, ret: &mut
 		*ret = virtual_address.as_mut_ptr();
 		return 0;
 	}
-	let physical_address = arch::mm::physicalmem::allocate(size).unwrap();
 
-	let count = size / BasePageSize::SIZE as usize;
-	let mut flags = PageTableEntryFlags::empty();
-	flags.normal().writable();
-	if prot_flags.contains(MemoryProtection::Write) {
-		flags.writable();
-	}
-	if !prot_flags.contains(MemoryProtection::Exec) {
-		flags.execute_disable();
+	// Only reserve the virtual address range; physical frames are allocated,
+	// zeroed, and mapped on first access by the page-fault handler.
+	#[cfg(all(target_arch = "x86_64", not(feature = "common-os")))]
+	{
+		demand_paging::register(virtual_address, size, page_table_entry_flags(prot_flags));
 	}
 
-	arch::mm::paging::map::<BasePageSize>(virtual_address, physical_address, count, flags);
+	#[cfg(not(all(target_arch = "x86_64", not(feature = "common-os"))))]
+	{
+		let physical_address = arch::mm::physicalmem::allocate(size).unwrap();
+
+		let count = size / BasePageSize::SIZE as usize;
+		arch::mm::paging::map::<BasePageSize>(
+			virtual_address,
+			physical_address,
+			count,
+			page_table_entry_flags(prot_flags),
+		);
+	}
 
 	*ret = virtual_address.as_mut_ptr();
 
@@ -58,12 +80,20 @@ pub extern "C" fn sys_munmap(ptr: *mut u8, size: usize) -> i32 {
 	let virtual_address = VirtAddr::from_usize(ptr as usize);
 	let size = size.align_up(BasePageSize::SIZE as usize);
 
-	if let Some(phys_addr) = arch::mm::paging::virtual_to_physical(virtual_address) {
-		arch::mm::paging::unmap::<BasePageSize>(
-			virtual_address,
-			size / BasePageSize::SIZE as usize,
-		);
-		arch::mm::physicalmem::deallocate(phys_addr, size);
+	#[cfg(all(target_arch = "x86_64", not(feature = "common-os")))]
+	{
+		demand_paging::unregister(virtual_address, size);
+		demand_paging::unmap_pages(virtual_address, size);
+	}
+
+	#[cfg(not(all(target_arch = "x86_64", not(feature = "common-os"))))]
+	for count in 0..size / BasePageSize::SIZE as usize {
+		let virtual_address = virtual_address + count * BasePageSize::SIZE as usize;
+
+		if let Some(phys_addr) = arch::mm::paging::virtual_to_physical(virtual_address) {
+			arch::mm::paging::unmap::<BasePageSize>(virtual_address, 1);
+			arch::mm::physicalmem::deallocate(phys_addr, BasePageSize::SIZE as usize);
+		}
 	}
 
 	arch::mm::virtualmem::deallocate(virtual_address, size);
@@ -78,24 +108,41 @@ pub extern "C" fn sys_munmap(ptr: *mut u8, size: usize) -> i32 {
 #[hermit_macro::system]
 #[no_mangle]
 pub extern "C" fn sys_mprotect(ptr: *mut u8, size: usize, prot_flags: MemoryProtection) -> i32 {
-	let count = size / BasePageSize::SIZE as usize;
-	let mut flags = PageTableEntryFlags::empty();
-	flags.normal().writable();
-	if prot_flags.contains(MemoryProtection::Write) {
-		flags.writable();
-	}
-	if !prot_flags.contains(MemoryProtection::Exec) {
-		flags.execute_disable();
+	let virtual_address = VirtAddr::from_usize(ptr as usize);
+	let size = size.align_up(BasePageSize::SIZE as usize);
+	let flags = page_table_entry_flags(prot_flags);
+
+	// Future faults in the range have to respect the new protection, and all
+	// pages that are already populated have to be remapped.
+	#[cfg(all(target_arch = "x86_64", not(feature = "common-os")))]
+	{
+		demand_paging::register(virtual_address, size, flags);
+		demand_paging::protect_pages(virtual_address, size, flags);
 	}
 
-	let virtual_address = VirtAddr::from_usize(ptr as usize);
+	#[cfg(not(all(target_arch = "x86_64", not(feature = "common-os"))))]
+	{
+		// Remap all pages that are already populated.
+		for count in 0..size / BasePageSize::SIZE as usize {
+			let virtual_address = virtual_address + count * BasePageSize::SIZE as usize;
 
-	if let Some(physical_address) = arch::mm::paging::virtual_to_physical(virtual_address) {
-		arch::mm::paging::map::<BasePageSize>(virtual_address, physical_address, count, flags);
-		0
-	} else {
-		let physical_address = arch::mm::physicalmem::allocate(size).unwrap();
-		arch::mm::paging::map::<BasePageSize>(virtual_address, physical_address, count, flags);
-		0
+			if let Some(physical_address) = arch::mm::paging::virtual_to_physical(virtual_address) {
+				arch::mm::paging::map::<BasePageSize>(virtual_address, physical_address, 1, flags);
+			}
+		}
+
+		// A region that was mapped with empty protection flags has no frames
+		// yet and has to be populated now.
+		if arch::mm::paging::virtual_to_physical(virtual_address).is_none() {
+			let physical_address = arch::mm::physicalmem::allocate(size).unwrap();
+			arch::mm::paging::map::<BasePageSize>(
+				virtual_address,
+				physical_address,
+				size / BasePageSize::SIZE as usize,
+				flags,
+			);
+		}
 	}
+
+	0
 }
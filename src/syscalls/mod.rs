@@ -20,7 +20,10 @@ pub use self::spinlock::*;
 pub use self::system::*;
 pub use self::tasks::*;
 pub use self::timer::*;
+pub use self::trace::*;
 use crate::env;
+#[cfg(any(feature = "tcp", feature = "udp"))]
+use crate::fd::PollEvent;
 use crate::fd::{
 	dup_object, get_object, remove_object, AccessPermission, EventFlags, FileDescriptor, IoCtl,
 	IoError, OpenOption, PollFd,
@@ -48,6 +51,7 @@ mod system;
 pub(crate) mod table;
 mod tasks;
 mod timer;
+mod trace;
 
 pub(crate) static SYS: Lazy<&'static dyn SyscallInterface> = Lazy::new(|| {
 	if env::is_uhyve() {
@@ -282,6 +286,9 @@ pub(crate) fn get_application_parameters() -> (i32, *const *const u8, *const *co
 }
 
 pub(crate) fn shutdown(arg: i32) -> ! {
+	// The console drain task does not run anymore.
+	crate::console::disable_buffering();
+
 	// print some performance statistics
 	crate::arch::kernel::print_statistics();
 	info!("shutting down with code {arg}");
@@ -690,6 +697,78 @@ pub extern "C" fn sys_eventfd(initval: u64, flags: i16) -> i32 {
 	}
 }
 
+/// Creates an event queue for readiness notification on registered
+/// sockets and returns a file descriptor referring to it.
+#[cfg(any(feature = "tcp", feature = "udp"))]
+#[hermit_macro::system]
+#[no_mangle]
+pub extern "C" fn sys_eventq_create() -> i32 {
+	crate::fd::eventq_create().unwrap_or_else(|e| -num::ToPrimitive::to_i32(&e).unwrap())
+}
+
+/// Registers the socket referenced by `sockfd` at the event queue `fd`
+/// with the interest set `events`. Readiness is reported edge-triggered:
+/// an event is queued when the socket becomes ready, not for as long as
+/// it stays ready.
+#[cfg(any(feature = "tcp", feature = "udp"))]
+#[hermit_macro::system]
+#[no_mangle]
+pub extern "C" fn sys_eventq_add(fd: i32, sockfd: i32, events: i16) -> i32 {
+	let Some(events) = PollEvent::from_bits(events) else {
+		return -crate::errno::EINVAL;
+	};
+
+	get_object(fd)
+		.and_then(|obj| obj.eventq_add(sockfd, events))
+		.map_or_else(|e| -num::ToPrimitive::to_i32(&e).unwrap(), |()| 0)
+}
+
+/// Removes the socket referenced by `sockfd` from the event queue `fd`.
+///
+/// A registered socket has to be removed from the queue before it is
+/// closed.
+#[cfg(any(feature = "tcp", feature = "udp"))]
+#[hermit_macro::system]
+#[no_mangle]
+pub extern "C" fn sys_eventq_del(fd: i32, sockfd: i32) -> i32 {
+	get_object(fd)
+		.and_then(|obj| obj.eventq_del(sockfd))
+		.map_or_else(|e| -num::ToPrimitive::to_i32(&e).unwrap(), |()| 0)
+}
+
+/// Waits on the event queue `fd` until registered sockets become ready
+/// and fills `events` with up to `maxevents` of them, with the ready
+/// events in the `revents` field. Returns the number of entries written.
+#[cfg(any(feature = "tcp", feature = "udp"))]
+#[hermit_macro::system]
+#[no_mangle]
+pub unsafe extern "C" fn sys_eventq_wait(
+	fd: i32,
+	events: *mut PollFd,
+	maxevents: usize,
+	timeout: i32,
+) -> i32 {
+	let slice = unsafe { core::slice::from_raw_parts_mut(events, maxevents) };
+	let timeout = if timeout >= 0 {
+		Some(core::time::Duration::from_millis(
+			timeout.try_into().unwrap(),
+		))
+	} else {
+		None
+	};
+
+	crate::fd::eventq_wait(fd, slice, timeout).map_or_else(
+		|e| {
+			if e == IoError::ETIME {
+				0
+			} else {
+				-num::ToPrimitive::to_i32(&e).unwrap()
+			}
+		},
+		|v| v.try_into().unwrap(),
+	)
+}
+
 #[hermit_macro::system]
 #[no_mangle]
 pub extern "C" fn sys_image_start_addr() -> usize {
@@ -1,6 +1,7 @@
 #![allow(dead_code)]
 #![allow(nonstandard_style)]
 use alloc::sync::Arc;
+use alloc::vec::Vec;
 use core::ffi::{c_char, c_void};
 use core::mem::size_of;
 use core::ops::DerefMut;
@@ -257,6 +258,24 @@ pub struct linger {
 	pub l_linger: i32,
 }
 
+/// Describes one datagram of a [`sys_sendmmsg`]/[`sys_recvmmsg`] batch.
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct mmsghdr {
+	/// Buffer holding the datagram to send or receiving the datagram.
+	pub msg_buf: *mut u8,
+	/// Size of the buffer.
+	pub msg_buflen: usize,
+	/// Length of the received datagram (filled in by `sys_recvmmsg`).
+	pub msg_len: usize,
+	/// Peer address of the datagram. May be null for `sys_recvmmsg` if the
+	/// source addresses are of no interest.
+	pub msg_addr: *mut sockaddr,
+	/// Size of the structure `msg_addr` points to (updated by
+	/// `sys_recvmmsg`).
+	pub msg_addrlen: socklen_t,
+}
+
 #[cfg(not(feature = "dns"))]
 #[hermit_macro::system]
 #[no_mangle]
@@ -811,3 +830,94 @@ pub unsafe extern "C" fn sys_recvfrom(
 		},
 	)
 }
+
+#[hermit_macro::system]
+#[no_mangle]
+pub unsafe extern "C" fn sys_sendmmsg(
+	fd: i32,
+	msgvec: *const mmsghdr,
+	vlen: u32,
+	_flags: i32,
+) -> i32 {
+	let msgvec = unsafe { core::slice::from_raw_parts(msgvec, vlen.try_into().unwrap()) };
+
+	let mut msgs = Vec::with_capacity(msgvec.len());
+	for hdr in msgvec {
+		let endpoint = if hdr.msg_addrlen == size_of::<sockaddr_in>().try_into().unwrap() {
+			IpEndpoint::from(unsafe { *(hdr.msg_addr as *const sockaddr_in) })
+		} else if hdr.msg_addrlen == size_of::<sockaddr_in6>().try_into().unwrap() {
+			IpEndpoint::from(unsafe { *(hdr.msg_addr as *const sockaddr_in6) })
+		} else {
+			return -crate::errno::EINVAL;
+		};
+		let slice = unsafe { core::slice::from_raw_parts(hdr.msg_buf, hdr.msg_buflen) };
+		msgs.push((slice, endpoint));
+	}
+
+	let obj = get_object(fd);
+	obj.map_or_else(
+		|e| -num::ToPrimitive::to_i32(&e).unwrap(),
+		|v| {
+			(*v).sendmsgs(&msgs).map_or_else(
+				|e| -num::ToPrimitive::to_i32(&e).unwrap(),
+				|sent| sent.try_into().unwrap(),
+			)
+		},
+	)
+}
+
+#[hermit_macro::system]
+#[no_mangle]
+pub unsafe extern "C" fn sys_recvmmsg(
+	fd: i32,
+	msgvec: *mut mmsghdr,
+	vlen: u32,
+	_flags: i32,
+) -> i32 {
+	let msgvec = unsafe { core::slice::from_raw_parts_mut(msgvec, vlen.try_into().unwrap()) };
+
+	let mut bufs: Vec<&mut [u8]> = msgvec
+		.iter()
+		.map(|hdr| unsafe { core::slice::from_raw_parts_mut(hdr.msg_buf, hdr.msg_buflen) })
+		.collect();
+
+	let obj = get_object(fd);
+	let msgs = match obj {
+		Ok(v) => match (*v).recvmsgs(&mut bufs) {
+			Ok(msgs) => msgs,
+			Err(e) => return -num::ToPrimitive::to_i32(&e).unwrap(),
+		},
+		Err(e) => return -num::ToPrimitive::to_i32(&e).unwrap(),
+	};
+	drop(bufs);
+
+	let received = msgs.len();
+	for (hdr, (len, endpoint)) in msgvec.iter_mut().zip(msgs) {
+		hdr.msg_len = len;
+
+		if !hdr.msg_addr.is_null() {
+			match endpoint.addr {
+				IpAddress::Ipv4(_) => {
+					if hdr.msg_addrlen >= size_of::<sockaddr_in>().try_into().unwrap() {
+						let addr = unsafe { &mut *(hdr.msg_addr as *mut sockaddr_in) };
+						*addr = sockaddr_in::from(endpoint);
+						hdr.msg_addrlen = size_of::<sockaddr_in>().try_into().unwrap();
+					} else {
+						return -crate::errno::EINVAL;
+					}
+				}
+				IpAddress::Ipv6(_) => {
+					if hdr.msg_addrlen >= size_of::<sockaddr_in6>().try_into().unwrap() {
+						let addr = unsafe { &mut *(hdr.msg_addr as *mut sockaddr_in6) };
+						*addr = sockaddr_in6::from(endpoint);
+						hdr.msg_addrlen = size_of::<sockaddr_in6>().try_into().unwrap();
+					} else {
+						return -crate::errno::EINVAL;
+					}
+				}
+			}
+		}
+	}
+
+	received.try_into().unwrap()
+}
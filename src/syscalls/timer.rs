@@ -1,7 +1,10 @@
+use core::ptr;
+use core::sync::atomic::{AtomicU32, AtomicU64, Ordering};
+
 use crate::arch;
 use crate::errno::*;
 use crate::syscalls::usleep;
-use crate::time::{itimerval, timespec, timeval};
+use crate::time::{itimerval, time_page, timespec, timeval};
 
 #[allow(non_camel_case_types)]
 pub type clockid_t = i32;
@@ -169,3 +172,44 @@ pub unsafe extern "C" fn sys_setitimer(
 	debug!("Called sys_setitimer, which is unimplemented and always returns 0");
 	0
 }
+
+/// Kernel-side mirror of [`time_page`] whose fields can be written
+/// atomically. The layouts match, so handing out a pointer to this page as
+/// a `time_page` is sound.
+#[repr(C)]
+struct SharedTimePage {
+	seq: AtomicU32,
+	_padding: u32,
+	tick_frequency: AtomicU64,
+	boot_time: AtomicU64,
+}
+
+static TIME_PAGE: SharedTimePage = SharedTimePage {
+	seq: AtomicU32::new(0),
+	_padding: 0,
+	tick_frequency: AtomicU64::new(0),
+	boot_time: AtomicU64::new(0),
+};
+
+/// Returns a pointer to the shared [`time_page`], so that applications can
+/// read the clocks without a syscall per reading.
+#[hermit_macro::system]
+#[no_mangle]
+pub extern "C" fn sys_time_page() -> *const time_page {
+	if TIME_PAGE.seq.load(Ordering::Acquire) == 0 {
+		// The calibration is constant after boot, so concurrent
+		// initializations write the same values and the sequence counter
+		// never needs to become odd.
+		TIME_PAGE.tick_frequency.store(
+			arch::processor::get_timestamp_frequency(),
+			Ordering::Relaxed,
+		);
+		TIME_PAGE.boot_time.store(
+			arch::kernel::systemtime::now_micros() - arch::processor::get_timer_ticks(),
+			Ordering::Relaxed,
+		);
+		TIME_PAGE.seq.store(2, Ordering::Release);
+	}
+
+	ptr::addr_of!(TIME_PAGE).cast()
+}
@@ -0,0 +1,55 @@
+use core::mem::size_of;
+use core::slice;
+
+use crate::errno::{EINVAL, ENOSYS};
+use crate::instrumentation::{self, trace_entry, TRACEPOINT_KIND_COUNT};
+
+/// Copies up to `len` of the most recent tracepoints recorded on core
+/// `core_id` into `buf`, oldest first, and returns how many were copied.
+/// Reading is a snapshot and does not consume the entries.
+///
+/// Returns `-ENOSYS` if the kernel was built without the `trace` feature
+/// and `-EINVAL` for an invalid core ID.
+#[hermit_macro::system]
+#[no_mangle]
+pub unsafe extern "C" fn sys_trace_read(core_id: u32, buf: *mut trace_entry, len: usize) -> isize {
+	if !cfg!(feature = "trace") {
+		return -ENOSYS as isize;
+	}
+
+	let buf = unsafe {
+		// Cap the number of entries to be read at a time to isize::MAX bytes
+		// to uphold the safety guarantees of `from_raw_parts`.
+		let len = usize::min(len, isize::MAX as usize / size_of::<trace_entry>());
+		slice::from_raw_parts_mut(buf, len)
+	};
+
+	match instrumentation::read(core_id as usize, buf) {
+		Some(copied) => copied.try_into().unwrap(),
+		None => -EINVAL as isize,
+	}
+}
+
+/// Copies the tracepoint counters of core `core_id` into `buf`, indexed by
+/// tracepoint kind, and returns how many counters were copied. `len` is
+/// the capacity of `buf` in counters.
+///
+/// Returns `-ENOSYS` if the kernel was built without the `trace` feature
+/// and `-EINVAL` for an invalid core ID.
+#[hermit_macro::system]
+#[no_mangle]
+pub unsafe extern "C" fn sys_trace_counters(core_id: u32, buf: *mut u64, len: usize) -> isize {
+	if !cfg!(feature = "trace") {
+		return -ENOSYS as isize;
+	}
+
+	let Some(counters) = instrumentation::counters(core_id as usize) else {
+		return -EINVAL as isize;
+	};
+
+	let copied = usize::min(len, TRACEPOINT_KIND_COUNT);
+	let buf = unsafe { slice::from_raw_parts_mut(buf, copied) };
+	buf.copy_from_slice(&counters[..copied]);
+
+	copied.try_into().unwrap()
+}
@@ -89,3 +89,33 @@ impl From<SystemTime> for timespec {
 		value.0
 	}
 }
+
+/// vDSO-style time page.
+///
+/// Since Hermit applications share the kernel's address space, the kernel
+/// can publish its timestamp-counter calibration instead of answering every
+/// `clock_gettime` with a full syscall. A reader obtains the page once via
+/// `sys_time_page` and computes
+///
+/// - `CLOCK_MONOTONIC` in microseconds as
+///   `timestamp * 1_000_000 / tick_frequency` and
+/// - `CLOCK_REALTIME` in microseconds by adding `boot_time` to that,
+///
+/// where `timestamp` is the architecture's timestamp counter (TSC on
+/// x86_64, CNTVCT on aarch64, `time` CSR on riscv64).
+///
+/// The page is valid once `seq` is non-zero and even; the fields do not
+/// change afterwards. While `seq` is zero, readers have to fall back to
+/// `sys_clock_gettime`.
+#[allow(non_camel_case_types)]
+#[repr(C)]
+pub struct time_page {
+	/// Non-zero and even once the remaining fields are published.
+	pub seq: u32,
+	pub _padding: u32,
+	/// Frequency of the timestamp counter in ticks per second.
+	pub tick_frequency: u64,
+	/// Wall-clock time at timestamp zero in microseconds since the Unix
+	/// epoch.
+	pub boot_time: u64,
+}
@@ -0,0 +1,141 @@
+#![no_std]
+#![no_main]
+
+extern crate hermit;
+
+use core::hint::black_box;
+use core::sync::atomic::AtomicU32;
+use core::sync::atomic::Ordering::Relaxed;
+
+use common::*;
+use hermit::syscalls::{
+	clockid_t, sys_clock_gettime, sys_futex_wait, sys_futex_wake, sys_getpid, sys_join, sys_spawn2,
+	sys_yield,
+};
+use hermit::time::timespec;
+
+mod common;
+
+const CLOCK_MONOTONIC: clockid_t = 4;
+const USER_STACK_SIZE: usize = 1_048_576;
+const NORMAL_PRIO: u8 = 2;
+
+const ITERATIONS: u64 = 100_000;
+
+fn now_ns() -> u64 {
+	let mut ts = timespec {
+		tv_sec: 0,
+		tv_nsec: 0,
+	};
+	let ret = unsafe { sys_clock_gettime(CLOCK_MONOTONIC, &mut ts) };
+	assert_eq!(ret, 0);
+	u64::try_from(ts.tv_sec).unwrap() * 1_000_000_000 + u64::try_from(ts.tv_nsec).unwrap()
+}
+
+/// Times `iterations` runs of `f` and reports the result both human- and
+/// machine-readable. The machine-readable lines are prefixed with
+/// `hermit-bench` and hold name, iterations, total nanoseconds and
+/// nanoseconds per iteration, separated by semicolons.
+fn bench(name: &str, iterations: u64, mut f: impl FnMut()) {
+	let start = now_ns();
+	for _ in 0..iterations {
+		f();
+	}
+	let total_ns = now_ns() - start;
+
+	let ns_per_iter = total_ns / iterations;
+	println!("{name}: {ns_per_iter} ns/iter");
+	println!("hermit-bench;{name};{iterations};{total_ns};{ns_per_iter}");
+}
+
+/// Cheapest syscall we have; measures the bare syscall entry/exit cost.
+fn bench_syscall_latency() {
+	bench("sys_getpid", ITERATIONS, || {
+		black_box(sys_getpid());
+	});
+}
+
+/// Yielding without a ready peer; measures one pass through the scheduler.
+fn bench_reschedule() {
+	bench("sys_yield_uncontended", ITERATIONS, || {
+		sys_yield();
+	});
+}
+
+extern "C" fn yield_loop(done: usize) {
+	let done = unsafe { &*(done as *const AtomicU32) };
+
+	while done.load(Relaxed) == 0 {
+		sys_yield();
+	}
+}
+
+/// Yielding with one ready peer on the same core; every iteration switches
+/// to the peer and back, so one iteration is two context switches.
+fn bench_context_switch() {
+	static DONE: AtomicU32 = AtomicU32::new(0);
+
+	let peer = unsafe {
+		sys_spawn2(
+			yield_loop,
+			&DONE as *const AtomicU32 as usize,
+			NORMAL_PRIO,
+			USER_STACK_SIZE,
+			-1,
+		)
+	};
+	assert!(peer >= 0);
+
+	bench("sys_yield_ping_pong", ITERATIONS, || {
+		sys_yield();
+	});
+
+	DONE.store(1, Relaxed);
+	sys_join(peer);
+}
+
+/// Waking a futex nobody waits on and waiting with a stale expected value;
+/// measures the fast paths through the parking lot.
+fn bench_futex() {
+	let futex = AtomicU32::new(0);
+	let futex_ptr = &futex as *const AtomicU32 as *mut u32;
+
+	bench("sys_futex_wake_empty", ITERATIONS, || {
+		let ret = unsafe { sys_futex_wake(futex_ptr, i32::MAX) };
+		assert_eq!(ret, 0);
+	});
+
+	bench("sys_futex_wait_eagain", ITERATIONS, || {
+		let ret = unsafe { sys_futex_wait(futex_ptr, 1, core::ptr::null(), 0) };
+		assert!(ret < 0);
+	});
+}
+
+/// Allocating and freeing from a single task; measures the allocator's
+/// round-trip cost for a small and a page-sized block.
+fn bench_allocator() {
+	bench("alloc_free_64", ITERATIONS, || {
+		let v = black_box(Vec::<u8>::with_capacity(64));
+		drop(v);
+	});
+
+	bench("alloc_free_4096", ITERATIONS, || {
+		let v = black_box(Vec::<u8>::with_capacity(4096));
+		drop(v);
+	});
+}
+
+#[no_mangle]
+pub fn main(_args: Vec<String>) -> Result<(), ()> {
+	println!("Running benchmarks, {ITERATIONS} iterations each");
+
+	bench_syscall_latency();
+	bench_reschedule();
+	bench_context_switch();
+	bench_futex();
+	bench_allocator();
+
+	Ok(())
+}
+
+runtime_entry_with_args!();
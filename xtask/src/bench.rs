@@ -0,0 +1,30 @@
+use anyhow::Result;
+use clap::Args;
+use xshell::cmd;
+
+/// Run the in-tree benchmark suite.
+///
+/// Builds `tests/bench.rs` like an integration test and runs it through the
+/// test runner under QEMU or uhyve. The benchmark results are printed to
+/// stdout; the lines prefixed with `hermit-bench` are machine-readable.
+#[derive(Args)]
+pub struct Bench {
+	/// Path to the bootloader for the test runner.
+	#[arg(long, default_value = "hermit-loader-x86_64")]
+	bootloader_path: String,
+}
+
+impl Bench {
+	pub fn run(self) -> Result<()> {
+		let sh = crate::sh()?;
+
+		let bootloader_path = &self.bootloader_path;
+		cmd!(sh, "cargo test --test bench --release")
+			.arg("--target=x86_64-unknown-none")
+			.arg("--")
+			.arg(format!("--bootloader_path={bootloader_path}"))
+			.run()?;
+
+		Ok(())
+	}
+}
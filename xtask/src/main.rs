@@ -3,6 +3,7 @@
 mod arch;
 mod archive;
 mod artifact;
+mod bench;
 mod binutil;
 mod build;
 mod cargo_build;
@@ -19,6 +20,7 @@ use xshell::Shell;
 
 #[derive(Parser)]
 enum Cli {
+	Bench(bench::Bench),
 	Build(build::Build),
 	#[command(subcommand)]
 	Ci(ci::Ci),
@@ -29,6 +31,7 @@ enum Cli {
 impl Cli {
 	fn run(self) -> Result<()> {
 		match self {
+			Self::Bench(bench) => bench.run(),
 			Self::Build(build) => build.run(),
 			Self::Ci(ci) => ci.run(),
 			Self::Clippy(clippy) => clippy.run(),